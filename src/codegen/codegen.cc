@@ -0,0 +1,191 @@
+#include "codegen.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <ios>
+#include <vector>
+
+namespace s21 {
+
+namespace {
+
+// Values written on one line of the arrays.
+constexpr std::size_t kValuesPerLine = 3;
+// Outputs of a layer computed together, their sums fill four AVX-512
+// registers.
+constexpr std::size_t kBlockSize = 32;
+
+bool IsIdentifier(const std::string &name) {
+  if (name.empty() or std::isdigit(static_cast<unsigned char>(name[0]))) {
+    return false;
+  }
+  return std::all_of(name.begin(), name.end(), [](char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) or c == '_';
+  });
+}
+
+const char *ActivationName(Activation activation) {
+  switch (activation) {
+    case Activation::kTanh:
+      return "Tanh";
+    case Activation::kRelu:
+      return "Relu";
+    default:
+      return "Sigmoid";
+  }
+}
+
+void WriteArray(std::ostream &out, const std::string &name, const Matrix &m) {
+  out << "alignas(" << kMatrixAlignment << ") constexpr double " << name
+      << "[" << m.GetSize() << "] = {";
+  for (std::size_t i = 0; i < m.GetSize(); ++i) {
+    const double value = m.begin()[i];
+    if (!std::isfinite(value)) {
+      throw std::invalid_argument("Weights must be finite to be generated");
+    }
+    out << (i % kValuesPerLine ? " " : "\n    ") << std::hexfloat << value
+        << std::defaultfloat << ",";
+  }
+  out << "\n};\n\n";
+}
+
+void WriteActivations(std::ostream &out) {
+  out << "inline double Sigmoid(double x) { return 1.0 / (1.0 + "
+         "std::exp(-x)); }\n"
+         "inline double Tanh(double x) { return std::tanh(x); }\n"
+         "inline double Relu(double x) { return x > 0.0 ? x : 0.0; }\n\n";
+}
+
+// Writes the outputs [begin, begin + count) of a layer as a loop over blocks
+// of `block` outputs, whose sums stay in registers across all the inputs.
+void WriteBlocks(std::ostream &out, std::size_t l, std::size_t in,
+                 std::size_t out_size, std::size_t begin, std::size_t count,
+                 std::size_t block, Activation activation,
+                 const std::string &input, const std::string &output) {
+  out << "  for (std::size_t j = " << begin << "; j < " << begin + count
+      << "; j += " << block << ") {\n"
+      << "    double sums[" << block << "];\n"
+      << "    for (std::size_t k = 0; k < " << block
+      << "; ++k) sums[k] = kBiases" << l << "[j + k];\n"
+      << "    for (std::size_t i = 0; i < " << in << "; ++i) {\n"
+      << "      const double x = " << input << "[i];\n"
+      << "      const double *row = kWeights" << l << " + i * " << out_size
+      << " + j;\n"
+      << "      for (std::size_t k = 0; k < " << block
+      << "; ++k) sums[k] += x * row[k];\n"
+      << "    }\n"
+      << "    for (std::size_t k = 0; k < " << block << "; ++k) {\n"
+      << "      " << output << "[j + k] = " << ActivationName(activation)
+      << "(sums[k]);\n"
+      << "    }\n"
+      << "  }\n";
+}
+
+void WriteLayer(std::ostream &out, std::size_t l, const Matrix &weights,
+                Activation activation, const std::string &input,
+                const std::string &output) {
+  const std::size_t in = weights.GetRows(), out_size = weights.GetCols();
+  const std::size_t blocked = out_size / kBlockSize * kBlockSize;
+  out << "  // Layer " << l + 1 << ": " << in << " -> " << out_size << ", "
+      << ActivationName(activation) << "\n";
+  if (blocked > 0) {
+    WriteBlocks(out, l, in, out_size, 0, blocked, kBlockSize, activation,
+                input, output);
+  }
+  if (blocked < out_size) {
+    WriteBlocks(out, l, in, out_size, blocked, out_size - blocked,
+                out_size - blocked, activation, input, output);
+  }
+}
+
+}  // namespace
+
+/**
+ * Writes the C++ sources of a trained model. The header declares
+ * `void <name>::Forward(const double *input, double *output)`, the source
+ * defines it with the weights as aligned constexpr arrays. The forward pass
+ * is one block per layer with every size written as a literal, so the
+ * compiler knows all the loop bounds and unrolls and vectorizes the loops
+ * over the outputs of a layer without reordering any sum; blocks of outputs
+ * keep their sums in registers across all the inputs. On x86-64 the function
+ * is cloned for AVX-512, AVX2 with FMA and the baseline, and the loader picks
+ * the clone of the CPU, so the default build does not run baseline SSE2
+ * code. The values are written as hexadecimal floating literals and are
+ * exact.
+ *
+ * @param file The weights read by ReadWeightsFile.
+ * @param name The namespace of the generated code, the source includes it
+ * as the header `<name>.h`.
+ * @param header The stream receiving the header.
+ * @param source The stream receiving the source.
+ * @throws std::invalid_argument If the name is not an identifier, the model
+ * is empty, its layers do not chain or a value is not finite.
+ */
+void GenerateModel(const WeightsFile &file, const std::string &name,
+                   std::ostream &header, std::ostream &source) {
+  if (!IsIdentifier(name)) {
+    throw std::invalid_argument("Invalid name of the generated model: " +
+                                name);
+  }
+  const Tensor &weights = file.weights;
+  if (weights.empty() or file.biases.size() != weights.size()) {
+    throw std::invalid_argument("The model has no layers");
+  }
+  for (std::size_t l = 0; l < weights.size(); ++l) {
+    if (file.biases[l].GetSize() != weights[l].GetCols() or
+        (l > 0 and weights[l].GetRows() != weights[l - 1].GetCols())) {
+      throw std::invalid_argument("The layers of the model do not chain");
+    }
+  }
+
+  std::string guard = name + "_H_";
+  std::transform(guard.begin(), guard.end(), guard.begin(), [](char c) {
+    return static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+  });
+  header << "// Generated by mlp_codegen, do not edit.\n"
+         << "#ifndef " << guard << "\n#define " << guard << "\n\n"
+         << "#include <cstddef>\n\n"
+         << "namespace " << name << " {\n\n"
+         << "constexpr std::size_t kInputs = " << weights.front().GetRows()
+         << ";\n"
+         << "constexpr std::size_t kOutputs = " << weights.back().GetCols()
+         << ";\n\n"
+         << "// Computes the kOutputs outputs of the kInputs inputs.\n"
+         << "void Forward(const double *input, double *output);\n\n"
+         << "}  // namespace " << name << "\n\n"
+         << "#endif  // " << guard << "\n";
+
+  source << "// Generated by mlp_codegen, do not edit.\n"
+         << "#include \"" << name << ".h\"\n\n"
+         << "#include <cmath>\n\n"
+         << "namespace " << name << " {\n\nnamespace {\n\n";
+  for (std::size_t l = 0; l < weights.size(); ++l) {
+    WriteArray(source, "kWeights" + std::to_string(l), weights[l]);
+    WriteArray(source, "kBiases" + std::to_string(l), file.biases[l]);
+  }
+  WriteActivations(source);
+  source << "}  // namespace\n\n"
+         << "#if defined(__GNUC__) && defined(__x86_64__) && defined(__ELF__)\n"
+         << "__attribute__((target_clones(\"arch=x86-64-v4\", "
+            "\"arch=x86-64-v3\", \"default\")))\n"
+         << "#endif\n"
+         << "void Forward(const double *input, double *output) {\n";
+  for (std::size_t l = 0; l + 1 < weights.size(); ++l) {
+    source << "  alignas(" << kMatrixAlignment << ") double layer" << l + 1
+           << "[" << weights[l].GetCols() << "];\n";
+  }
+  std::string input = "input";
+  for (std::size_t l = 0; l < weights.size(); ++l) {
+    const std::string output =
+        l + 1 < weights.size() ? "layer" + std::to_string(l + 1) : "output";
+    const Activation activation = l < file.activations.size()
+                                      ? file.activations[l]
+                                      : Activation::kSigmoid;
+    WriteLayer(source, l, weights[l], activation, input, output);
+    input = output;
+  }
+  source << "}\n\n}  // namespace " << name << "\n";
+}
+
+}  // namespace s21
@@ -0,0 +1,17 @@
+#ifndef MLP_CODEGEN_CODEGEN_H_
+#define MLP_CODEGEN_CODEGEN_H_
+
+#include <ostream>
+#include <string>
+
+#include "mlp.h"
+
+namespace s21 {
+
+// Writes the header and the source of a model with built-in weights.
+void GenerateModel(const WeightsFile &file, const std::string &name,
+                   std::ostream &header, std::ostream &source);
+
+}  // namespace s21
+
+#endif  // MLP_CODEGEN_CODEGEN_H_
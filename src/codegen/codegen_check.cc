@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "mlp.h"
+#include "mlp_model.h"
+
+using namespace s21;
+
+namespace {
+
+// Largest difference allowed between the generated model and the MLP, the
+// products of the matrix model sum in another order.
+constexpr double kTolerance = 1e-9;
+constexpr std::size_t kSamples = 1000;
+// Passes over the samples timed for each model, the fastest one counts.
+constexpr int kRepeats = 5;
+
+// Microseconds per sample of the fastest of kRepeats runs of the function
+// over all the samples.
+template <typename F>
+double BestTime(F &&run) {
+  double best = 0.0;
+  for (int repeat = 0; repeat < kRepeats; ++repeat) {
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < kSamples; ++i) run(i);
+    const double us = std::chrono::duration<double, std::micro>(
+                          std::chrono::steady_clock::now() - start)
+                          .count() /
+                      kSamples;
+    if (repeat == 0 or us < best) best = us;
+  }
+  return best;
+}
+
+}  // namespace
+
+// Compares the outputs of the generated model with the ones of the MLP
+// loading the weights it was generated from, on random inputs, and times
+// both. Fails when the outputs differ or the generated model is not faster.
+int main() {
+  MLP mlp{Topology{}};
+  mlp.Load(MLP_CODEGEN_WEIGHTS);
+  if (mlp.GetTopology().GetInputSize() != mlp_model::kInputs or
+      mlp.GetTopology().GetOutputSize() != mlp_model::kOutputs) {
+    std::cerr << "The generated model has other sizes than "
+              << MLP_CODEGEN_WEIGHTS << "\n";
+    return 1;
+  }
+
+  SeedRandomWeights(1);
+  std::vector<Vector> inputs(kSamples, Vector(mlp_model::kInputs));
+  for (Vector &input : inputs) RandomizeVector(input);
+
+  std::vector<Vector> expected(kSamples);
+  const double mlp_us =
+      BestTime([&](std::size_t i) { expected[i] = mlp.Predict(inputs[i]); });
+  std::vector<Vector> outputs(kSamples, Vector(mlp_model::kOutputs));
+  const double generated_us = BestTime([&](std::size_t i) {
+    mlp_model::Forward(inputs[i].data(), outputs[i].data());
+  });
+
+  double max_error = 0.0;
+  for (std::size_t i = 0; i < kSamples; ++i) {
+    for (std::size_t j = 0; j < mlp_model::kOutputs; ++j) {
+      max_error = std::max(max_error, std::abs(outputs[i][j] - expected[i][j]));
+    }
+  }
+  std::cout << "MLP " << mlp_us << " us/sample, generated " << generated_us
+            << " us/sample, max error " << max_error << "\n";
+  if (max_error > kTolerance) return 1;
+  if (generated_us >= mlp_us) {
+    std::cerr << "The generated model is not faster than the MLP\n";
+    return 1;
+  }
+  return 0;
+}
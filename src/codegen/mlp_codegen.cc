@@ -0,0 +1,31 @@
+#include <fstream>
+#include <iostream>
+
+#include "codegen.h"
+
+using namespace s21;
+
+// Usage: mlp_codegen <weights> <output directory> [name]
+// Writes <name>.h and <name>.cc, the name defaults to mlp_model.
+int main(int argc, char **argv) {
+  if (argc < 3 or argc > 4) {
+    std::cerr << "Usage: " << argv[0]
+              << " <weights> <output directory> [name]\n";
+    return 1;
+  }
+  const std::string name = argc == 4 ? argv[3] : "mlp_model";
+  const std::string stem = std::string(argv[2]) + "/" + name;
+
+  try {
+    const WeightsFile file = ReadWeightsFile(argv[1]);
+    std::ofstream header(stem + ".h"), source(stem + ".cc");
+    if (!header.is_open() or !source.is_open()) {
+      throw std::runtime_error("Failed to open the output files: " + stem);
+    }
+    GenerateModel(file, name, header, source);
+  } catch (const std::exception &e) {
+    std::cerr << argv[0] << ": " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
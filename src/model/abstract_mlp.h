@@ -1,14 +1,63 @@
 #ifndef MLP_MODEL_ABSTRACT_MLP_H_
 #define MLP_MODEL_ABSTRACT_MLP_H_
 
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <variant>
 #include <vector>
 
+#include "matrix.h"
+#include "optimizer.h"
+#include "simd.h"
+
 namespace s21 {
 
-using Vector = std::vector<double>;
-using Matrix = std::vector<Vector>;
 using Tensor = std::vector<Matrix>;
 
+/**
+ * @struct BasicLayerView
+ * @brief Non-owning views of the weights and the biases of a layer of a
+ * model, in the layout of GetMlp: one row per input and one column per
+ * neuron, the biases as one row. The views point to the storage of the
+ * model, whatever its layout, and stay valid until the model is rebuilt.
+ */
+template <typename T>
+struct BasicLayerView {
+  using value_type = T;
+
+  BasicMatrixView<const T> weights;
+  BasicMatrixView<const T> biases;
+};
+
+using LayerView = BasicLayerView<double>;
+using FloatLayerView = BasicLayerView<float>;
+// Views of all the layers, in the scalar type the model stores.
+using LayerViews =
+    std::variant<std::vector<LayerView>, std::vector<FloatLayerView>>;
+
+// Copies a view of any scalar type into a matrix of doubles.
+template <typename T>
+Matrix CopyView(BasicMatrixView<const T> view) {
+  Matrix matrix(view.GetRows(), view.GetCols());
+  for (std::size_t i = 0; i < view.GetRows(); ++i) {
+    for (std::size_t j = 0; j < view.GetCols(); ++j) {
+      matrix(i, j) = view(i, j);
+    }
+  }
+  return matrix;
+}
+
+/**
+ * @class Workspace
+ * @brief Buffers of one data-parallel worker, defined by the model: the
+ * activations and deltas of its shard of a batch and the gradients.
+ */
+class Workspace {
+ public:
+  virtual ~Workspace() = default;
+};
+
 /**
  * @class AbstractMlp
  * @brief Abstract class for Multi-Layer Perceptrons (MLPs).
@@ -27,8 +76,82 @@ class AbstractMlp {
   virtual void ForwardPropagation() = 0;
   virtual void BackPropagation(const Vector &, double) = 0;
   virtual Vector GetOutput() const = 0;
-  virtual std::pair<const Tensor, const Tensor> GetMlp() const = 0;
+  // Copies the output into a vector owned by the caller, which avoids the
+  // allocation of GetOutput once the vector has the output size.
+  virtual void CopyOutput(Vector &output) const { output = GetOutput(); }
+  // Views of the weights and the biases of every layer, which readers like
+  // MLP::Save consume without copying the model.
+  virtual LayerViews GetLayerViews() const = 0;
+  // Copies of the weights and the biases of every layer, as doubles.
+  virtual std::pair<const Tensor, const Tensor> GetMlp() const {
+    Tensor weights, biases;
+    std::visit(
+        [&](const auto &layers) {
+          for (const auto &layer : layers) {
+            weights.push_back(CopyView(layer.weights));
+            biases.push_back(CopyView(layer.biases));
+          }
+        },
+        GetLayerViews());
+    return {weights, biases};
+  }
   virtual void SetMlp(const Tensor &, const Tensor &) = 0;
+  // Selects the update rule of the training steps and resets its state.
+  // Models only supporting plain SGD throw std::logic_error for the others.
+  virtual void SetOptimizer(const Optimizer &optimizer) {
+    if (optimizer.type != Optimizer::Type::kSgd) {
+      throw std::logic_error("Model only supports the SGD optimizer");
+    }
+  }
+  // Selects how the activation kernels of this model evaluate the sigmoid.
+  MathMode GetMathMode() const { return math_mode_; }
+  void SetMathMode(MathMode mode) { math_mode_ = mode; }
+
+  // Mini-batch training, every row of the matrices is one sample and the
+  // outputs of the forward pass are returned in the last argument. Batched
+  // models average the gradients over the rows before a single update; this
+  // default trains on the rows one at a time.
+  virtual void TrainBatch(const Matrix &inputs, const Matrix &expected,
+                          double lr, Matrix &outputs) {
+    outputs.Resize(inputs.GetRows(), expected.GetCols());
+    for (std::size_t i = 0; i < inputs.GetRows(); ++i) {
+      SetInputLayer(Vector(inputs[i], inputs[i] + inputs.GetCols()));
+      ForwardPropagation();
+      const Vector output = GetOutput();
+      std::copy(output.begin(), output.end(), outputs[i]);
+      BackPropagation(Vector(expected[i], expected[i] + expected.GetCols()),
+                      lr);
+    }
+  }
+
+  // Data-parallel training. Every worker computes the gradients summed over
+  // its shard of a batch into its own workspace, reading the shared weights
+  // only; the workspaces are then summed and the sum is applied once. Models
+  // returning no workspace are trained with TrainBatch instead.
+  virtual std::unique_ptr<Workspace> CreateWorkspace() const {
+    return nullptr;
+  }
+  virtual void ComputeGradients(const Matrix &, const Matrix &, Workspace &,
+                                Matrix &) const {
+    throw std::logic_error("Model does not support data-parallel training");
+  }
+  virtual void ReduceGradients(Workspace &, const Workspace &) const {
+    throw std::logic_error("Model does not support data-parallel training");
+  }
+  virtual void ApplyGradients(const Workspace &, double) {
+    throw std::logic_error("Model does not support data-parallel training");
+  }
+
+  // Asynchronous (Hogwild) training: like TrainBatch, with the buffers of a
+  // worker workspace, and the update is applied to the shared weights
+  // without any synchronization between the workers.
+  virtual void TrainBatchAsync(const Matrix &, const Matrix &, double,
+                               Workspace &, Matrix &) {
+    throw std::logic_error("Model does not support asynchronous training");
+  }
+
+ protected:
+  MathMode math_mode_ = MathMode::kExact;
 };
 }  // namespace s21
 
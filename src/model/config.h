@@ -2,8 +2,12 @@
 #define MLP_MODEL_CONFIG_H_
 
 #include <cstddef>
+#include <stdexcept>
 #include <vector>
 
+#include "activation_functions.h"
+#include "optimizer.h"
+
 namespace s21 {
 
 /**
@@ -12,17 +16,21 @@ namespace s21 {
  *
  * The Topology class provides methods to retrieve and modify the architecture
  * of a neural network, including the number of layers, sizes of layers,
- * input and output sizes, and hidden layer sizes.
+ * input and output sizes, and hidden layer sizes. Every layer but the input
+ * one has its own activation, the sigmoid by default.
  */
 class Topology {
  public:
-  Topology() : sizes_{784, 100, 100, 26} {}
+  Topology() : sizes_{784, 100, 100, 26}, activations_(sizes_.size()) {}
   explicit Topology(std::size_t hidden_num) : sizes_{784} {
     sizes_.insert(sizes_.end(), hidden_num, 100);
     sizes_.push_back(26);
+    activations_.resize(sizes_.size());
   }
-  explicit Topology(std::initializer_list<std::size_t> sizes) : sizes_{sizes} {}
-  explicit Topology(const std::vector<std::size_t>& sizes) : sizes_{sizes} {}
+  explicit Topology(std::initializer_list<std::size_t> sizes)
+      : sizes_{sizes}, activations_(sizes_.size()) {}
+  explicit Topology(const std::vector<std::size_t>& sizes)
+      : sizes_{sizes}, activations_(sizes_.size()) {}
 
   std::size_t GetInputSize() const { return sizes_.front(); }
   void SetInputSize(std::size_t size) { sizes_.front() = size; }
@@ -33,10 +41,40 @@ class Topology {
   std::size_t GetLayerSize(std::size_t idx) const { return sizes_[idx]; }
   void SetLayerSize(std::size_t size, std::size_t idx) { sizes_[idx] = size; }
   std::size_t GetLastHidden() const { return sizes_[sizes_.size() - 2]; }
-  void SetTopology(const std::vector<std::size_t>& sizes) { sizes_ = sizes; }
+
+  // Layers added or removed by SetTopology take the activation of the first
+  // hidden layer, the output layer keeps its own.
+  void SetTopology(const std::vector<std::size_t>& sizes) {
+    if (sizes.size() != sizes_.size()) {
+      const Activation hidden =
+          sizes_.size() > 2 ? activations_[1] : Activation::kSigmoid;
+      const Activation output = activations_.back();
+      activations_.assign(sizes.size(), hidden);
+      activations_.back() = output;
+    }
+    sizes_ = sizes;
+  }
+
+  Activation GetActivation(std::size_t idx) const { return activations_[idx]; }
+  void SetActivation(Activation activation, std::size_t idx) {
+    if (idx == 0 or idx >= sizes_.size()) {
+      throw std::out_of_range("Layer has no activation");
+    }
+    activations_[idx] = activation;
+  }
+  void SetHiddenActivation(Activation activation) {
+    for (std::size_t i = 1; i + 1 < sizes_.size(); ++i) {
+      activations_[i] = activation;
+    }
+  }
+  void SetOutputActivation(Activation activation) {
+    activations_.back() = activation;
+  }
 
  private:
   std::vector<std::size_t> sizes_;
+  // Indexed like the sizes, the entry of the input layer is unused.
+  std::vector<Activation> activations_;
 };
 
 /**
@@ -49,16 +87,28 @@ class Topology {
  */
 class Config {
  public:
-  enum class ModelType { kMatrix, kGraph };
-  enum class TrainType { kTrain, kCrossValidation };
+  // The quantized model is inference only, it is built from trained weights.
+  // The static model is only available for the topologies compiled in it.
+  enum class ModelType { kMatrix, kGraph, kQuantized, kStatic };
+  // Hogwild trains on one slice of the dataset per thread at once, the
+  // threads update the shared weights without locks.
+  enum class TrainType { kTrain, kCrossValidation, kHogwild };
+  // Scalar type of the matrix model, the graph model always uses double.
+  enum class Precision { kDouble, kFloat };
 
   explicit Config()
       : model_type_{ModelType::kMatrix},
         train_type_{TrainType::kTrain},
+        precision_{Precision::kDouble},
         test_sample_{1.0},
         k_folds_{3},
         epochs_{5},
+        batch_size_{1},
+        threads_{1},
+        seed_{0},
+        math_mode_{MathMode::kExact},
         learning_rate_{0.1},
+        optimizer_{},
         activate_threshold_{0.5},
         verbose_{false} {}
 
@@ -66,14 +116,29 @@ class Config {
   void SetModelType(ModelType type) { model_type_ = type; }
   TrainType GetTrainType() const { return train_type_; }
   void SetTrainType(TrainType type) { train_type_ = type; }
+  Precision GetPrecision() const { return precision_; }
+  void SetPrecision(Precision precision) { precision_ = precision; }
   double GetTestSample() const { return test_sample_; }
   void SetTestSample(double sample) { test_sample_ = sample; }
   std::size_t GetKFolds() const { return k_folds_; }
   void SetKFolds(std::size_t k_folds) { k_folds_ = k_folds; }
   std::size_t GetEpochs() const { return epochs_; }
   void SetEpochs(std::size_t epochs) { epochs_ = epochs; }
+  std::size_t GetBatchSize() const { return batch_size_; }
+  void SetBatchSize(std::size_t size) { batch_size_ = size; }
+  // Workers of data-parallel training, each batch is split between them.
+  std::size_t GetThreads() const { return threads_; }
+  void SetThreads(std::size_t threads) { threads_ = threads; }
+  // Seed of the shuffling and of the weights, zero draws a random one.
+  unsigned GetSeed() const { return seed_; }
+  void SetSeed(unsigned seed) { seed_ = seed; }
+  // Evaluation of the sigmoid, the fast mode uses a polynomial exponential.
+  MathMode GetMathMode() const { return math_mode_; }
+  void SetMathMode(MathMode mode) { math_mode_ = mode; }
   double GetLearningRate() const { return learning_rate_; }
   void SetLearningRate(double rate) { learning_rate_ = rate; }
+  const Optimizer &GetOptimizer() const { return optimizer_; }
+  void SetOptimizer(const Optimizer &optimizer) { optimizer_ = optimizer; }
   bool GetVerbose() const { return verbose_; }
   void SetVerbose(bool verbose) { verbose_ = verbose; }
   double GetActivateThreshold() const { return activate_threshold_; }
@@ -82,10 +147,16 @@ class Config {
  private:
   ModelType model_type_;
   TrainType train_type_;
+  Precision precision_;
   double test_sample_;
   std::size_t k_folds_;
   std::size_t epochs_;
+  std::size_t batch_size_;
+  std::size_t threads_;
+  unsigned seed_;
+  MathMode math_mode_;
   double learning_rate_;
+  Optimizer optimizer_;
   double activate_threshold_;
   bool verbose_;
 };
@@ -2,22 +2,89 @@
 
 namespace s21 {
 
-GraphMlp::GraphMlp(const Topology& topology) {
-  net_.clear();
+namespace {
+
+// Nodes of a chain of layers, every one taking the values of the previous one.
+std::vector<GraphNode> ChainNodes(const Topology& topology) {
+  std::vector<GraphNode> nodes(topology.GetLayersCount());
+  nodes[0].size = topology.GetInputSize();
+  for (std::size_t i = 1; i < nodes.size(); ++i) {
+    nodes[i] = {topology.GetLayerSize(i), {i - 1}, topology.GetActivation(i)};
+  }
+  return nodes;
+}
+
+}  // namespace
+
+GraphMlp::GraphMlp(const Topology& topology) : GraphMlp(ChainNodes(topology)) {}
 
-  net_.emplace_back(std::make_shared<Layer>(topology.GetInputSize()));
+GraphMlp::GraphMlp(const std::vector<GraphNode>& nodes) { Build(nodes); }
 
-  for (std::size_t i = 1; i <= topology.GetHiddenCount(); ++i) {
-    auto new_layer =
-        std::make_shared<Layer>(topology.GetLayerSize(i), net_[i - 1]);
-    net_.emplace_back(new_layer);
-    net_[i - 1]->SetNextLayer(new_layer);
+/**
+ * Creates the layers of a graph and the successors of its nodes for the
+ * scheduler.
+ *
+ * @param nodes The nodes, the input layer first and the output layer last.
+ * @throws std::invalid_argument If a node is empty, if the first node has
+ * inputs or another one has none, if a node takes values from a later node
+ * or twice from the same one, or if a node other than the last feeds none.
+ */
+void GraphMlp::Build(const std::vector<GraphNode>& nodes) {
+  if (nodes.size() < 2) {
+    throw std::invalid_argument("Graph needs an input and an output layer");
+  }
+  std::vector<std::vector<std::size_t>> forward(nodes.size());
+  std::vector<std::vector<std::size_t>> backward(nodes.size());
+  std::vector<std::size_t> depths(nodes.size(), 0);
+  for (std::size_t k = 0; k < nodes.size(); ++k) {
+    if (nodes[k].size == 0) {
+      throw std::invalid_argument("Graph layer is empty");
+    }
+    if ((k == 0) != nodes[k].inputs.empty()) {
+      throw std::invalid_argument("Only the first graph layer has no inputs");
+    }
+    for (std::size_t input : nodes[k].inputs) {
+      if (input >= k) {
+        throw std::invalid_argument("Graph layer takes a later layer");
+      }
+      if (!forward[input].empty() and forward[input].back() == k) {
+        throw std::invalid_argument("Graph layer takes a layer twice");
+      }
+      forward[input].push_back(k);
+      backward[k].push_back(input);
+      depths[k] = std::max(depths[k], depths[input] + 1);
+    }
+  }
+  for (std::size_t k = 0; k + 1 < nodes.size(); ++k) {
+    if (forward[k].empty()) {
+      throw std::invalid_argument("Graph layer feeds no layer");
+    }
+  }
+
+  std::vector<bool> used(nodes.size(), false);
+  branches_ = false;
+  for (std::size_t depth : depths) {
+    branches_ = branches_ or used[depth];
+    used[depth] = true;
   }
 
-  auto output_layer =
-      std::make_shared<Layer>(topology.GetOutputSize(), net_.back());
-  net_.emplace_back(output_layer);
-  net_[net_.size() - 2]->SetNextLayer(output_layer);
+  net_.clear();
+  for (std::size_t k = 0; k < nodes.size(); ++k) {
+    std::vector<std::shared_ptr<Layer>> inputs;
+    for (std::size_t input : nodes[k].inputs) {
+      inputs.push_back(net_[input]);
+    }
+    net_.emplace_back(
+        std::make_shared<Layer>(nodes[k].size, inputs, nodes[k].activation));
+    std::size_t column = 0;
+    for (std::size_t input : nodes[k].inputs) {
+      net_[input]->AddNextLayer(net_[k], column);
+      column += nodes[input].size;
+    }
+  }
+  nodes_ = nodes;
+  forward_ = std::move(forward);
+  backward_ = std::move(backward);
 }
 
 void GraphMlp::SetInputLayer(const Vector& input_values) {
@@ -28,73 +95,93 @@ void GraphMlp::SetInputLayer(const Vector& input_values) {
   net_[0]->SetValues(input_values);
 }
 
+// A layer starts once the layers it takes values from are done.
 void GraphMlp::ForwardPropagation() {
-  for (std::size_t i = 1; i < net_.size(); ++i) {
-    net_[i]->FeedForward();
+  const auto feed = [this](std::size_t node) {
+    if (node > 0) net_[node]->FeedForward(math_mode_);
+  };
+  if (branches_) {
+    GetThreadPool().ParallelForGraph(forward_, feed);
+  } else {
+    for (std::size_t i = 0; i < net_.size(); ++i) feed(i);
   }
 }
 
+/**
+ * Computes the errors of every layer once the layers it feeds are done, then
+ * updates all the weights, which are independent. The errors of the input
+ * layer would not be used.
+ *
+ * @param expected The expected output.
+ * @param learning_rate The learning rate.
+ */
 void GraphMlp::BackPropagation(const Vector& expected, double learning_rate) {
-  net_.back()->CalculateOutputError(expected);
-
-  for (int i = net_.size() - 2; i >= 0; --i) {
-    net_[i]->CalculateError();
-  }
-
-  for (std::size_t i = net_.size() - 1; i > 0; --i) {
-    net_[i]->UpdateWeights(learning_rate);
-  }
-}
-
-Vector GraphMlp::GetOutput() const {
-  Vector output;
-  auto& output_layer = net_.back()->GetLayer();
-  for (std::size_t i = 0; i < output_layer.size(); ++i) {
-    output.push_back(output_layer[i].GetValue());
+  const auto error = [&](std::size_t node) {
+    if (node + 1 == net_.size()) {
+      net_[node]->CalculateOutputError(expected);
+    } else if (node > 0) {
+      net_[node]->CalculateError();
+    }
+  };
+  const auto update = [&](std::size_t node) {
+    net_[node]->UpdateWeights(learning_rate);
+  };
+  if (branches_) {
+    GetThreadPool().ParallelForGraph(backward_, error);
+    GetThreadPool().ParallelFor(net_.size(), update);
+  } else {
+    for (std::size_t i = net_.size(); i-- > 0;) error(i);
+    for (std::size_t i = net_.size(); i-- > 0;) update(i);
   }
-
-  return output;
 }
 
-std::pair<const Tensor, const Tensor> GraphMlp::GetMlp() const {
-  Tensor weights, biases;
+Vector GraphMlp::GetOutput() const { return net_.back()->GetValues(); }
 
+// The layers store one row of weights per neuron, they are viewed
+// transposed.
+LayerViews GraphMlp::GetLayerViews() const {
+  std::vector<LayerView> layers;
   for (std::size_t i = 1; i < net_.size(); ++i) {
-    Matrix layer_weights;
-    Matrix layer_biases(1);
-
-    for (Neuron& neuron : net_[i]->GetLayer()) {
-      layer_weights.emplace_back(neuron.GetWeights());
-      layer_biases[0].emplace_back(neuron.GetBias());
-    }
-
-    weights.emplace_back(std::move(Transpose(layer_weights)));
-    biases.emplace_back(std::move(layer_biases));
+    const Vector& biases = net_[i]->GetBiases();
+    layers.push_back({net_[i]->GetWeights().GetView().Transposed(),
+                      {biases.data(), 1, biases.size(), biases.size()}});
   }
-
-  return {weights, biases};
+  return layers;
 }
 
+/**
+ * Sets the weights of the layers. Weights of other shapes, e.g. read by
+ * MLP::Load, replace the graph by a chain of layers of their shapes.
+ *
+ * @param weights The weights of every layer but the input one, one column
+ * per neuron.
+ * @param biases The biases of the same layers.
+ * @throws std::invalid_argument If there are no weights or if the biases do
+ * not match them.
+ */
 void GraphMlp::SetMlp(const Tensor& weights, const Tensor& biases) {
-  net_.clear();
-
-  net_.emplace_back(std::make_shared<Layer>(weights[0].size()));
-
-  for (std::size_t i = 1; i < weights.size(); ++i) {
-    net_.emplace_back(std::make_shared<Layer>(weights[i].size(), net_[i - 1]));
-    net_[i - 1]->SetNextLayer(net_[i]);
+  if (weights.empty() or biases.size() != weights.size()) {
+    throw std::invalid_argument("Weights do not match the biases");
   }
-
-  net_.emplace_back(
-      std::make_shared<Layer>(weights.back()[0].size(), net_.back()));
-  net_[net_.size() - 2]->SetNextLayer(net_.back());
-
-  for (std::size_t i = 0; i < net_.size() - 1; ++i) {
-    Matrix m = Transpose(weights[i]);
-    for (std::size_t j = 0; j < net_[i + 1]->GetSize(); ++j) {
-      net_[i + 1]->GetLayer()[j].SetWeights(m[j]);
-      net_[i + 1]->GetLayer()[j].SetBias(biases[i][0][j]);
+  bool same = weights.size() + 1 == net_.size();
+  for (std::size_t i = 0; same and i < weights.size(); ++i) {
+    same = weights[i].GetRows() == net_[i + 1]->GetWeights().GetCols() and
+           weights[i].GetCols() == net_[i + 1]->GetSize();
+  }
+  if (!same) {
+    std::vector<GraphNode> nodes(weights.size() + 1);
+    nodes[0].size = weights[0].GetRows();
+    for (std::size_t i = 1; i < nodes.size(); ++i) {
+      nodes[i] = {weights[i - 1].GetCols(), {i - 1}, Activation::kSigmoid};
+      if (nodes_.size() == nodes.size()) {
+        nodes[i].activation = nodes_[i].activation;
+      }
     }
+    Build(nodes);
+  }
+
+  for (std::size_t i = 0; i < weights.size(); ++i) {
+    net_[i + 1]->SetWeights(Transpose(weights[i]), biases[i]);
   }
 }
 
@@ -6,6 +6,18 @@
 
 namespace s21 {
 
+/**
+ * @struct GraphNode
+ * @brief A layer of a GraphMlp built as a directed acyclic graph: its size,
+ * the indices of the nodes it takes values from, concatenated in this order,
+ * and its activation.
+ */
+struct GraphNode {
+  std::size_t size = 0;
+  std::vector<std::size_t> inputs;
+  Activation activation = Activation::kSigmoid;
+};
+
 /**
  * @class GraphMlp
  * @brief Implementation of Multi-Layer Perceptron (MLP) using a graph-based
@@ -16,20 +28,39 @@ namespace s21 {
  * one. It inherits from the AbstractMlp interface and provides methods for
  * setting input layers, performing forward and backward propagations and
  * accessing MLP parameters.
+ *
+ * Besides a chain of layers, the model can be built from any directed
+ * acyclic graph of layers, e.g. with skip connections or parallel branches
+ * joined by a layer taking all of them. When the graph has layers that do not
+ * depend on each other, the passes run them concurrently on the thread pool;
+ * the layers of a chain split their neurons between the threads instead.
  */
 class GraphMlp : public AbstractMlp {
  public:
   explicit GraphMlp(const Topology& topology);
+  explicit GraphMlp(const std::vector<GraphNode>& nodes);
 
   void SetInputLayer(const Vector& input_values) override;
   void ForwardPropagation() override;
   void BackPropagation(const Vector& expected, double learning_rate) override;
   Vector GetOutput() const override;
-  std::pair<const Tensor, const Tensor> GetMlp() const override;
+  LayerViews GetLayerViews() const override;
   void SetMlp(const Tensor&, const Tensor&) override;
 
+  const std::vector<GraphNode>& GetNodes() const { return nodes_; }
+
  private:
+  void Build(const std::vector<GraphNode>& nodes);
+
   std::vector<std::shared_ptr<Layer>> net_;
+  // The first node is the input layer and the last one the output layer,
+  // every node only takes values from nodes before it.
+  std::vector<GraphNode> nodes_;
+  // Successors of every node in the forward and in the backward pass.
+  std::vector<std::vector<std::size_t>> forward_;
+  std::vector<std::vector<std::size_t>> backward_;
+  // Whether some nodes are at the same depth and can run concurrently.
+  bool branches_ = false;
 };
 
 }  // namespace s21
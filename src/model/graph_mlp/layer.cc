@@ -2,83 +2,177 @@
 
 namespace s21 {
 
-Layer::Layer(std::size_t size, std::shared_ptr<Layer> prev)
-    : layer_(size), prev_layer_(prev), next_layer_(nullptr) {
-  for (Neuron& neuron : layer_) {
-    neuron = Neuron(prev ? prev->GetSize() : 0);
+Layer::Layer(std::size_t size, std::shared_ptr<Layer> prev,
+             Activation activation)
+    : Layer(size,
+            prev ? std::vector<std::shared_ptr<Layer>>{prev}
+                 : std::vector<std::shared_ptr<Layer>>{},
+            activation) {}
+
+/**
+ * Creates a layer taking the values of its inputs, concatenated in order,
+ * with random weights and zero biases.
+ *
+ * @param size The number of neurons.
+ * @param inputs The layers feeding this one, none for an input layer.
+ * @param activation The activation of the neurons.
+ */
+Layer::Layer(std::size_t size,
+             const std::vector<std::shared_ptr<Layer>>& inputs,
+             Activation activation)
+    : values_(size),
+      errors_(size),
+      biases_(size),
+      weights_(size, std::accumulate(inputs.begin(), inputs.end(),
+                                     std::size_t{0},
+                                     [](std::size_t sum, const auto& input) {
+                                       return sum + input->GetSize();
+                                     })),
+      activation_(activation),
+      prev_layers_(inputs) {
+  std::generate(weights_.begin(), weights_.end(), RandomWeight);
+  layer_.reserve(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    layer_.emplace_back(&values_[i], &errors_[i], &biases_[i], weights_[i],
+                        weights_.GetCols());
   }
 }
 
 void Layer::SetValues(const Vector& values) {
-  if (values.size() != layer_.size()) {
+  if (values.size() != values_.size()) {
     throw std::invalid_argument("Input size doesn't match layer size");
   }
 
-  for (std::size_t i = 0; i < layer_.size(); ++i) {
-    layer_[i].SetValue(values[i]);
-  }
+  std::copy(values.begin(), values.end(), values_.begin());
 }
 
-void Layer::FeedForward() {
-  for (Neuron& neuron : layer_) {
-    neuron.CalculateValue(GetPrevValues());
+/**
+ * Calls body(begin, end) for the blocks of [0, count) on the shared thread
+ * pool when the pass does enough work to pay for it, otherwise calls it once
+ * for the whole range on the calling thread.
+ *
+ * @param count The number of neurons.
+ * @param work The number of multiply-adds of the pass.
+ */
+template <typename F>
+void Layer::ForEachBlock(std::size_t count, std::size_t work, F&& body) {
+  if (work >= kLayerParallelWork) {
+    GetThreadPool().ParallelForRange(count, kLayerBlock, body);
+  } else {
+    body(0, count);
   }
 }
 
+/**
+ * Computes the weighted sums of all the neurons from the values of the
+ * input layers, read in place, as dot products with the segments of the
+ * rows of the weight matrix, then activates them by one call of the SIMD
+ * kernel.
+ *
+ * @param mode The math mode of the model, which selects the sigmoid kernel.
+ */
+void Layer::FeedForward(MathMode mode) {
+  const SimdKernels& kernels = GetSimdKernels();
+  const auto activate = ActivationKernel(activation_, kernels, mode);
+  const auto forward = [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+      double sum = biases_[i];
+      const double* row = weights_[i];
+      for (const auto& input : prev_layers_) {
+        const Vector& prev_values = input->GetValues();
+        sum += kernels.dot(row, prev_values.data(), prev_values.size());
+        row += prev_values.size();
+      }
+      values_[i] = sum;
+    }
+    activate(values_.data() + begin, values_.data() + begin, end - begin);
+  };
+  ForEachBlock(values_.size(), weights_.GetSize(), forward);
+}
+
 void Layer::CalculateOutputError(const Vector& expected) {
-  if (expected.size() != layer_.size()) {
+  if (expected.size() != values_.size()) {
     throw std::invalid_argument(
         "Expected output size doesn't match layer size");
   }
 
   std::size_t idx = std::distance(
       expected.begin(), std::find(expected.begin(), expected.end(), 1.0));
-  for (std::size_t i = 0; i < layer_.size(); ++i) {
-    double value = layer_[i].GetValue();
-    double target = (i == idx) ? 1.0 : 0.0;
-    layer_[i].CalculateError(target - value);
-  }
+  VisitActivation(activation_, [&](auto policy) {
+    for (std::size_t i = 0; i < values_.size(); ++i) {
+      double target = (i == idx) ? 1.0 : 0.0;
+      errors_[i] = (target - values_[i]) * policy.Derivative(values_[i]);
+    }
+  });
 }
 
+/**
+ * Propagates the errors of the next layers back through their weights. The
+ * sums are the products of the transposed weights of the next layers by
+ * their errors, accumulated row by row: every row of the columns fed by
+ * this layer is read once and in order, scaled by the error of its neuron.
+ * In parallel, every block of neurons reads its columns of all the rows.
+ */
 void Layer::CalculateError() {
-  for (std::size_t i = 0; i < layer_.size(); ++i) {
-    layer_[i].CalculateError(ErrorSum(i));
+  const SimdKernels& kernels = GetSimdKernels();
+  std::fill(errors_.begin(), errors_.end(), 0.0);
+  if (next_layers_.empty()) return;
+  std::size_t work = 0;
+  for (const auto& [next, column] : next_layers_) {
+    work += next->GetSize() * errors_.size();
   }
-}
-
-void Layer::UpdateWeights(double learning_rate) {
-  if (prev_layer_) {
-    for (Neuron& neuron : layer_) {
-      neuron.UpdateWeights(GetPrevValues(), learning_rate);
+  const auto backward = [&](std::size_t begin, std::size_t end) {
+    for (const auto& [next, column] : next_layers_) {
+      const Vector& errors = next->GetErrors();
+      const Matrix& weights = next->GetWeights();
+      for (std::size_t i = 0; i < errors.size(); ++i) {
+        kernels.axpy(errors[i], weights[i] + column + begin,
+                     errors_.data() + begin, end - begin);
+      }
     }
-  }
+    VisitActivation(activation_, [&](auto policy) {
+      for (std::size_t i = begin; i < end; ++i) {
+        errors_[i] *= policy.Derivative(values_[i]);
+      }
+    });
+  };
+  ForEachBlock(errors_.size(), work, backward);
 }
 
-double Layer::ErrorSum(std::size_t idx) const {
-  double sum = 0.0;
-
-  if (next_layer_) {
-    for (std::size_t i = 0; i < next_layer_->GetLayer().size(); ++i) {
-      sum += next_layer_->GetLayer()[i].GetError() *
-             next_layer_->GetLayer()[i].GetWeight(idx);
+// Every row of weights moves along the concatenated values of the inputs.
+void Layer::UpdateWeights(double learning_rate) {
+  if (prev_layers_.empty()) return;
+  const SimdKernels& kernels = GetSimdKernels();
+  const auto update = [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+      const double step = learning_rate * errors_[i];
+      double* row = weights_[i];
+      for (const auto& input : prev_layers_) {
+        const Vector& prev_values = input->GetValues();
+        kernels.axpy(step, prev_values.data(), row, prev_values.size());
+        row += prev_values.size();
+      }
+      biases_[i] += step;
     }
-  }
-
-  return sum;
+  };
+  ForEachBlock(values_.size(), weights_.GetSize(), update);
 }
 
-Vector Layer::GetPrevValues() const {
-  Vector prev_values;
-  if (prev_layer_) {
-    auto& prev_layer = prev_layer_->GetLayer();
-    prev_values.reserve(prev_layer.size());
-
-    for (Neuron& neuron : prev_layer) {
-      prev_values.push_back(neuron.GetValue());
-    }
+/**
+ * Sets the incoming weights and the biases of the layer.
+ *
+ * @param weights The weights, one row per neuron of the layer.
+ * @param biases The biases, one per neuron.
+ * @throws std::invalid_argument If the dimensions do not match the layer.
+ */
+void Layer::SetWeights(const Matrix& weights, const Matrix& biases) {
+  if (weights.GetRows() != weights_.GetRows() or
+      weights.GetCols() != weights_.GetCols() or
+      biases.GetSize() != biases_.size()) {
+    throw std::invalid_argument("Weights size doesn't match layer size");
   }
-
-  return prev_values;
+  std::copy(weights.begin(), weights.end(), weights_.begin());
+  std::copy(biases.begin(), biases.end(), biases_.begin());
 }
 
 }  // namespace s21
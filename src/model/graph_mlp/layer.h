@@ -2,43 +2,80 @@
 #define MODEL_GRAPH_MLP_LAYER_H_
 
 #include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
 
 #include "neuron.h"
 
 namespace s21 {
 
+// Layers whose weight matrix has at least kLayerParallelWork elements split
+// their passes between the threads by blocks of kLayerBlock neurons.
+constexpr std::size_t kLayerParallelWork = 1 << 16;
+constexpr std::size_t kLayerBlock = 32;
+
 /**
  * @class Layer
  * @brief Represents a layer of neurons in a Multi-Layer Perceptron (MLP).
  *
  * The Layer class provides methods for setting neuron values, performing
  * feedforward and backpropagation operations, as well as updating weights
- * during training.
+ * during training. The layer stores the state of its neurons as structure of
+ * arrays: the values, errors and biases in contiguous vectors and the
+ * incoming weights in a size x previous size matrix, one row per neuron.
+ * The neurons are views of these buffers, so the layer is not copyable.
+ *
+ * A layer may take the values of several layers, concatenated in the order
+ * of its inputs along the columns of its weights, and feed several layers,
+ * so the layers of a GraphMlp can form any directed acyclic graph.
  */
 class Layer {
  public:
-  explicit Layer(std::size_t size, std::shared_ptr<Layer> prev = nullptr);
+  explicit Layer(std::size_t size, std::shared_ptr<Layer> prev = nullptr,
+                 Activation activation = Activation::kSigmoid);
+  Layer(std::size_t size, const std::vector<std::shared_ptr<Layer>>& inputs,
+        Activation activation = Activation::kSigmoid);
+  Layer(const Layer&) = delete;
+  Layer& operator=(const Layer&) = delete;
 
   void SetValues(const Vector& values);
-  void FeedForward();
+  void FeedForward(MathMode);
   void CalculateOutputError(const Vector& expected);
   void CalculateError();
   void UpdateWeights(double learning_rate);
 
   std::vector<Neuron>& GetLayer() { return layer_; }
+  const std::vector<Neuron>& GetLayer() const { return layer_; }
   std::size_t GetSize() const { return layer_.size(); }
+  Activation GetActivation() const { return activation_; }
+  const Vector& GetValues() const { return values_; }
+  const Vector& GetErrors() const { return errors_; }
+  const Vector& GetBiases() const { return biases_; }
+  const Matrix& GetWeights() const { return weights_; }
+  void SetWeights(const Matrix& weights, const Matrix& biases);
 
-  void SetNextLayer(std::shared_ptr<Layer> next) { next_layer_ = next; }
-  std::shared_ptr<Layer> GetNext() { return next_layer_; }
-  std::shared_ptr<Layer> GetPrev() { return prev_layer_; }
+  // Registers a layer fed by this one; column is where the values of this
+  // layer start among the inputs of the next one.
+  void AddNextLayer(std::shared_ptr<Layer> next, std::size_t column = 0) {
+    next_layers_.emplace_back(next, column);
+  }
+  const std::vector<std::shared_ptr<Layer>>& GetInputs() const {
+    return prev_layers_;
+  }
 
  private:
+  Vector values_;
+  Vector errors_;
+  Vector biases_;
+  Matrix weights_;
   std::vector<Neuron> layer_;
-  std::shared_ptr<Layer> prev_layer_;
-  std::shared_ptr<Layer> next_layer_;
+  Activation activation_;
+  std::vector<std::shared_ptr<Layer>> prev_layers_;
+  std::vector<std::pair<std::shared_ptr<Layer>, std::size_t>> next_layers_;
 
-  double ErrorSum(std::size_t idx) const;
-  Vector GetPrevValues() const;
+  template <typename F>
+  static void ForEachBlock(std::size_t count, std::size_t work, F&& body);
 };
 
 }  // namespace s21
@@ -2,37 +2,41 @@
 
 namespace s21 {
 
-Neuron::Neuron(std::size_t prev_size)
-    : value_(0.0), error_(0.0), bias_(0.0), weights_(prev_size) {
-  std::generate(weights_.begin(), weights_.end(), RandomWeight);
+Neuron::Neuron(double* value, double* error, double* bias, double* weights,
+               std::size_t prev_size)
+    : value_(value),
+      error_(error),
+      bias_(bias),
+      weights_(weights),
+      size_(prev_size) {}
+
+void Neuron::SetWeights(const Vector& weights) {
+  if (weights.size() != size_) {
+    throw std::invalid_argument("Weights size doesn't match previous layer");
+  }
+  std::copy(weights.begin(), weights.end(), weights_);
 }
 
-void Neuron::CalculateValue(const Vector& prev_values) {
-  if (prev_values.size() != weights_.size()) {
+double Neuron::WeightedSum(const Vector& prev_values) const {
+  if (prev_values.size() != size_) {
     throw std::invalid_argument("Next size doesn't match weight size");
   }
 
-  double sum = bias_;
-  for (std::size_t i = 0; i < prev_values.size(); ++i) {
-    sum += prev_values[i] * weights_[i];
-  }
-  value_ = ApplyActivation(sum, sigmoid);
+  return *bias_ + GetSimdKernels().dot(weights_, prev_values.data(), size_);
 }
 
-void Neuron::CalculateError(double err) {
-  error_ = err * ApplyActivationDerivative(value_, sigmoid_derivative);
+void Neuron::CalculateError(double err, Activation activation) {
+  *error_ = err * ApplyActivationDerivative(*value_, activation);
 }
 
 void Neuron::UpdateWeights(const Vector& prev_values, double learning_rate) {
-  if (prev_values.size() != weights_.size()) {
+  if (prev_values.size() != size_) {
     throw std::invalid_argument("Next size doesn't match weight size");
   }
 
-  for (std::size_t i = 0; i < weights_.size(); ++i) {
-    weights_[i] += learning_rate * error_ * prev_values[i];
-  }
-
-  bias_ += learning_rate * error_;
+  GetSimdKernels().axpy(learning_rate * *error_, prev_values.data(), weights_,
+                        size_);
+  *bias_ += learning_rate * *error_;
 }
 
 }  // namespace s21
@@ -12,32 +12,38 @@ namespace s21 {
  *
  * The Neuron class defines the properties and operations of an individual
  * neuron within a neural network. It provides methods for calculating the
- * neuron's value, error, and weight updates during training.
+ * neuron's value, error, and weight updates during training. A neuron is a
+ * view of its entries in the contiguous buffers of its Layer: the value, the
+ * error, the bias and the row of incoming weights of the weight matrix. It
+ * is valid as long as the layer.
  */
 class Neuron {
  public:
-  explicit Neuron(std::size_t prev_size = 0);
-
-  void SetValue(double value) { value_ = value; }
-  void SetError(double error) { error_ = error; }
-  void SetBias(double bias) { bias_ = bias; }
-  void SetWeights(const Vector& weights) { weights_ = weights; }
-
-  double GetValue() const { return value_; }
-  double GetError() const { return error_; }
-  double GetBias() const { return bias_; }
-  const Vector& GetWeights() const { return weights_; }
+  Neuron(double* value, double* error, double* bias, double* weights,
+         std::size_t prev_size);
+
+  void SetValue(double value) { *value_ = value; }
+  void SetError(double error) { *error_ = error; }
+  void SetBias(double bias) { *bias_ = bias; }
+  void SetWeights(const Vector& weights);
+
+  double GetValue() const { return *value_; }
+  double GetError() const { return *error_; }
+  double GetBias() const { return *bias_; }
+  Vector GetWeights() const { return Vector(weights_, weights_ + size_); }
   double GetWeight(std::size_t idx) const { return weights_[idx]; }
+  std::size_t GetWeightsCount() const { return size_; }
 
-  void CalculateValue(const Vector& prev_values);
-  void CalculateError(double err);
+  double WeightedSum(const Vector& prev_values) const;
+  void CalculateError(double err, Activation activation);
   void UpdateWeights(const Vector& prev_values, double learning_rate);
 
  private:
-  double value_;
-  double error_;
-  double bias_;
-  Vector weights_;
+  double* value_;
+  double* error_;
+  double* bias_;
+  double* weights_;
+  std::size_t size_;
 };
 
 }  // namespace s21
@@ -8,25 +8,27 @@
 namespace s21 {
 
 /**
- * @class Image
+ * @class BasicImage
  * @brief Represents an image with pixel values and associated label.
  *
- * The Image class encapsulates an image along with its pixel values and a
- * label indicating its corresponding classification. It provides methods to
- * access and modify the label, pixel values, and perform normalization.
+ * The BasicImage class encapsulates an image along with its pixel values and
+ * a label indicating its corresponding classification. It provides methods to
+ * access and modify the label, pixel values, and perform normalization. The
+ * pixels are stored in the scalar type T.
  */
-class Image {
+template <typename T>
+class BasicImage {
  public:
-  using Pixels = std::vector<double>;
+  using Pixels = std::vector<T>;
 
-  static constexpr const double kMaxPixel = 255.0;
+  static constexpr const T kMaxPixel = 255;
   static constexpr const std::size_t kHeight = 28;
   static constexpr const std::size_t kWidth = 28;
   static constexpr const std::size_t kPixels = kHeight * kWidth;
 
-  Image() : label_{0u} { pixels_.reserve(kPixels); }
-  explicit Image(const Pixels& pixels) : label_(0u), pixels_(pixels) {}
-  Image(const Pixels& pixels, std::size_t label)
+  BasicImage() : label_{0u} { pixels_.reserve(kPixels); }
+  explicit BasicImage(const Pixels& pixels) : label_(0u), pixels_(pixels) {}
+  BasicImage(const Pixels& pixels, std::size_t label)
       : label_(label), pixels_(pixels) {
     Normalize();
   }
@@ -34,12 +36,12 @@ class Image {
   std::size_t GetLabel() const { return label_; }
   void SetLabel(std::size_t label) { label_ = label; }
   const Pixels& GetPixels() const { return pixels_; }
-  void AddPixel(double pixel) { pixels_.push_back(pixel); }
+  void AddPixel(T pixel) { pixels_.push_back(pixel); }
   char GetLetter() const { return static_cast<char>(label_) + 'A' - 1; }
 
   void Normalize() {
     std::transform(pixels_.begin(), pixels_.end(), pixels_.begin(),
-                   [](double d) -> double { return d / kMaxPixel; });
+                   [](T d) -> T { return d / kMaxPixel; });
   }
 
   void Transform() {
@@ -85,7 +87,7 @@ class Image {
 
     for (std::size_t row = 0; row < kWidth; ++row) {
       for (std::size_t col = 0; col < kHeight; ++col) {
-        double pixel = pixels_[row * kWidth + col];
+        T pixel = pixels_[row * kWidth + col];
         std::size_t idx =
             static_cast<std::size_t>(pixel * (symbols.size() - 1));
         std::cout << symbols[idx];
@@ -99,6 +101,9 @@ class Image {
   Pixels pixels_;
 };
 
+using Image = BasicImage<double>;
+using FloatImage = BasicImage<float>;
+
 }  // namespace s21
 
 #endif  // MLP_MODEL_IMAGE_H_
@@ -2,55 +2,395 @@
 
 namespace s21 {
 
-MatrixMlp::MatrixMlp(const Topology &topology)
+namespace {
+
+template <typename To, typename From>
+std::vector<BasicMatrix<To>> ConvertLayers(
+    const std::vector<BasicMatrix<From>> &layers) {
+  return {layers.begin(), layers.end()};
+}
+
+}  // namespace
+
+template <typename T>
+BasicMatrixMlp<T>::BasicMatrixMlp(const Topology &topology)
     : weights_(topology.GetLayersCount() - 1),
       biases_(topology.GetLayersCount() - 1),
-      values_(topology.GetLayersCount()) {
+      activations_(topology.GetLayersCount() - 1),
+      steps_{0} {
   for (std::size_t i = 0; i < topology.GetLayersCount() - 1; ++i) {
-    weights_[i] =
-        Matrix(topology.GetLayerSize(i), Vector(topology.GetLayerSize(i + 1)));
+    activations_[i] = topology.GetActivation(i + 1);
+    weights_[i] = BasicMatrix<T>(topology.GetLayerSize(i),
+                                 topology.GetLayerSize(i + 1));
     RandomizeMatrix(weights_[i]);
-    biases_[i] = Matrix(1, Vector(topology.GetLayerSize(i + 1)));
+    biases_[i] = BasicMatrix<T>(1, topology.GetLayerSize(i + 1));
     RandomizeMatrix(biases_[i]);
   }
+  workspace_ = MakeWorkspace(false);
+}
+
+/**
+ * Creates the buffers of a training step for a single sample; they grow to
+ * the size of the batch on the first batched step.
+ *
+ * @param gradients Whether to allocate the weight and bias gradients.
+ * @return The workspace.
+ */
+template <typename T>
+typename BasicMatrixMlp<T>::BatchWorkspace BasicMatrixMlp<T>::MakeWorkspace(
+    bool gradients) const {
+  BatchWorkspace workspace;
+  workspace.values.emplace_back(1, weights_.front().GetRows());
+  for (std::size_t i = 0; i < weights_.size(); ++i) {
+    const std::size_t size = weights_[i].GetCols();
+    workspace.values.emplace_back(1, size);
+    workspace.errors.emplace_back(1, size);
+    workspace.derivatives.emplace_back(1, size);
+    if (gradients) {
+      workspace.weight_gradients.emplace_back(weights_[i].GetRows(), size);
+      workspace.bias_gradients.emplace_back(1, size);
+    }
+  }
+  workspace.expected = BasicMatrix<T>(1, weights_.back().GetCols());
+  return workspace;
+}
+
+template <typename T>
+void BasicMatrixMlp<T>::SetInputLayer(const Vector &input) {
+  workspace_.values[0].Resize(1, input.size());
+  std::copy(input.cbegin(), input.cend(), workspace_.values[0].begin());
+}
+
+template <typename T>
+void BasicMatrixMlp<T>::ForwardPropagation() {
+  Forward(workspace_);
+}
+
+template <typename T>
+void BasicMatrixMlp<T>::Forward(BatchWorkspace &workspace) const {
+  Layers &values = workspace.values;
+  for (std::size_t i = 0; i < weights_.size(); ++i) {
+    ActivateLayer(values[i], weights_[i], biases_[i], activations_[i],
+                  values[i + 1], math_mode_);
+  }
+}
+
+template <typename T>
+void BasicMatrixMlp<T>::BackPropagation(const Vector &expected, double lr) {
+  workspace_.expected.Resize(1, expected.size());
+  std::copy(expected.cbegin(), expected.cend(),
+            workspace_.expected.begin());
+  Backward(workspace_, lr);
+}
+
+template <typename T>
+void BasicMatrixMlp<T>::SetBatch(const Matrix &inputs, const Matrix &expected,
+                                 BatchWorkspace &workspace) const {
+  workspace.values[0].Resize(inputs.GetRows(), inputs.GetCols());
+  std::copy(inputs.begin(), inputs.end(), workspace.values[0].begin());
+  workspace.expected.Resize(expected.GetRows(), expected.GetCols());
+  std::copy(expected.begin(), expected.end(), workspace.expected.begin());
+  if (inputs.GetRows() > 1) {
+    workspace.ones.Resize(1, inputs.GetRows());
+    workspace.ones.Fill(T{1});
+  }
 }
 
-void MatrixMlp::SetInputLayer(const Vector &input) {
-  values_[0] = Matrix(1, input);
+/**
+ * Trains on a batch of samples at once. The activations of every layer are
+ * batch x size matrices, so the propagations are matrix products instead of
+ * vector-matrix ones, and the gradients summed by the products over the
+ * batch are averaged into a single update.
+ *
+ * @param inputs The input samples, one per row.
+ * @param expected The expected outputs, one per row.
+ * @param lr The learning rate.
+ * @param outputs Receives the outputs of the forward pass.
+ */
+template <typename T>
+void BasicMatrixMlp<T>::TrainBatch(const Matrix &inputs,
+                                   const Matrix &expected, double lr,
+                                   Matrix &outputs) {
+  SetBatch(inputs, expected, workspace_);
+  Forward(workspace_);
+  const BasicMatrix<T> &output = workspace_.values.back();
+  outputs.Resize(output.GetRows(), output.GetCols());
+  std::copy(output.begin(), output.end(), outputs.begin());
+  Backward(workspace_, lr / static_cast<double>(inputs.GetRows()));
 }
 
-void MatrixMlp::ForwardPropagation() {
+/**
+ * Trains on a batch with the buffers of a worker workspace and updates the
+ * shared weights without locks. Workers calling it concurrently race on the
+ * weights on purpose: with small updates the lost ones barely matter, which
+ * is the bet of Hogwild training.
+ *
+ * @param inputs The input samples, one per row.
+ * @param expected The expected outputs, one per row.
+ * @param lr The learning rate.
+ * @param base The workspace created by CreateWorkspace().
+ * @param outputs Receives the outputs of the forward pass.
+ */
+template <typename T>
+void BasicMatrixMlp<T>::TrainBatchAsync(const Matrix &inputs,
+                                        const Matrix &expected, double lr,
+                                        Workspace &base, Matrix &outputs) {
+  auto &workspace = static_cast<BatchWorkspace &>(base);
+  SetBatch(inputs, expected, workspace);
+  Forward(workspace);
+  const BasicMatrix<T> &output = workspace.values.back();
+  outputs.Resize(output.GetRows(), output.GetCols());
+  std::copy(output.begin(), output.end(), outputs.begin());
+  Backward(workspace, lr / static_cast<double>(inputs.GetRows()));
+}
+
+template <typename T>
+void BasicMatrixMlp<T>::OutputErrors(BatchWorkspace &workspace) const {
+  ActivateDerivativeInto(workspace.derivatives.back(), workspace.values.back(),
+                         activations_.back());
+  SubtractInto(workspace.errors.back(), workspace.values.back(),
+               workspace.expected);
+  MultiplyHadamardInPlace(workspace.errors.back(),
+                          workspace.derivatives.back());
+}
+
+/**
+ * Propagates the deltas of a layer to the previous one through its weights.
+ *
+ * @param workspace The buffers holding the deltas of the layer.
+ * @param layer The index of the layer, at least 1.
+ */
+template <typename T>
+void BasicMatrixMlp<T>::PropagateErrors(BatchWorkspace &workspace,
+                                        std::size_t layer) const {
+  MultiplyNTInto(workspace.errors[layer - 1], workspace.errors[layer],
+                 weights_[layer]);
+  ActivateDerivativeInto(workspace.derivatives[layer - 1],
+                         workspace.values[layer], activations_[layer - 1]);
+  MultiplyHadamardInPlace(workspace.errors[layer - 1],
+                          workspace.derivatives[layer - 1]);
+}
+
+/**
+ * Computes the deltas of every layer from the weights of the forward pass,
+ * then updates all the layers, so a step applies the gradient of the whole
+ * batch like ComputeGradients and ApplyGradients, without gradient buffers.
+ *
+ * @param workspace The buffers of the forward pass.
+ * @param lr The learning rate, the caller divides it by the batch size.
+ */
+template <typename T>
+void BasicMatrixMlp<T>::Backward(BatchWorkspace &workspace, double lr) {
+  if (optimizer_.type != Optimizer::Type::kSgd) {
+    Gradients(workspace);
+    ApplyGradients(workspace, lr);
+    return;
+  }
+  OutputErrors(workspace);
+  for (std::size_t i = weights_.size() - 1; i > 0; --i) {
+    PropagateErrors(workspace, i);
+  }
+
+  const bool batched = workspace.expected.GetRows() > 1;
   for (std::size_t i = 0; i < weights_.size(); ++i) {
-    values_[i + 1] = Activate(values_[i] * weights_[i] + biases_[i], sigmoid);
+    if (batched) {
+      MultiplyTNInto(weights_[i], workspace.values[i], workspace.errors[i],
+                     -lr, 1.0);
+      MultiplyInto(biases_[i], workspace.ones, workspace.errors[i], -lr, 1.0);
+    } else {
+      GerInto(weights_[i], -lr, workspace.values[i], workspace.errors[i]);
+      AxpyInto(biases_[i], -lr, workspace.errors[i]);
+    }
   }
 }
 
-void MatrixMlp::BackPropagation(const Vector &expected, double lr) {
-  Matrix errors =
-      MultiplyHadamard(values_.back() - Matrix(1, expected),
-                       ActivateDerivative(values_.back(), sigmoid_derivative));
+template <typename T>
+std::unique_ptr<Workspace> BasicMatrixMlp<T>::CreateWorkspace() const {
+  return std::make_unique<BatchWorkspace>(MakeWorkspace(true));
+}
+
+/**
+ * Computes the gradients summed over a shard of a batch into a workspace.
+ * The weights are only read, so workers may call it concurrently with their
+ * own workspaces.
+ *
+ * @param inputs The input samples, one per row.
+ * @param expected The expected outputs, one per row.
+ * @param base The workspace created by CreateWorkspace().
+ * @param outputs Receives the outputs of the forward pass.
+ */
+template <typename T>
+void BasicMatrixMlp<T>::ComputeGradients(const Matrix &inputs,
+                                         const Matrix &expected,
+                                         Workspace &base,
+                                         Matrix &outputs) const {
+  auto &workspace = static_cast<BatchWorkspace &>(base);
+  SetBatch(inputs, expected, workspace);
+  Forward(workspace);
+  const BasicMatrix<T> &output = workspace.values.back();
+  outputs.Resize(output.GetRows(), output.GetCols());
+  std::copy(output.begin(), output.end(), outputs.begin());
 
+  Gradients(workspace);
+}
+
+/**
+ * Computes the gradients summed over the samples of a workspace into it,
+ * from the outputs of its forward pass.
+ *
+ * @param workspace A workspace with gradient buffers.
+ */
+template <typename T>
+void BasicMatrixMlp<T>::Gradients(BatchWorkspace &workspace) const {
+  const std::size_t samples = workspace.expected.GetRows();
+  OutputErrors(workspace);
   for (std::size_t i = weights_.size(); i-- > 0;) {
-    weights_[i] -= Transpose(values_[i]) * errors * lr;
-    biases_[i] -= errors * lr;
-    errors =
-        MultiplyHadamard(errors * Transpose(weights_[i]),
-                         ActivateDerivative(values_[i], sigmoid_derivative));
+    MultiplyTNInto(workspace.weight_gradients[i], workspace.values[i],
+                   workspace.errors[i]);
+    if (samples > 1) {
+      MultiplyInto(workspace.bias_gradients[i], workspace.ones,
+                   workspace.errors[i]);
+    } else {
+      std::copy(workspace.errors[i].begin(), workspace.errors[i].end(),
+                workspace.bias_gradients[i].begin());
+    }
+    if (i > 0) PropagateErrors(workspace, i);
+  }
+  workspace.samples = samples;
+}
+
+/**
+ * Adds the gradients of one workspace to another one.
+ *
+ * @param base The workspace receiving the sum.
+ * @param other The workspace to be added.
+ */
+template <typename T>
+void BasicMatrixMlp<T>::ReduceGradients(Workspace &base,
+                                        const Workspace &other) const {
+  auto &sum = static_cast<BatchWorkspace &>(base);
+  const auto &gradients = static_cast<const BatchWorkspace &>(other);
+  for (std::size_t i = 0; i < weights_.size(); ++i) {
+    AddInPlace(sum.weight_gradients[i], gradients.weight_gradients[i]);
+    AddInPlace(sum.bias_gradients[i], gradients.bias_gradients[i]);
+  }
+  sum.samples += gradients.samples;
+}
+
+/**
+ * Updates the weights with the gradients of a workspace. The optimizers
+ * other than SGD average the gradients over the samples and update every
+ * weight and bias tensor with its moments in a single fused kernel pass.
+ *
+ * @param base The workspace holding the gradients.
+ * @param lr The learning rate, the caller divides it by the batch size.
+ */
+template <typename T>
+void BasicMatrixMlp<T>::ApplyGradients(const Workspace &base, double lr) {
+  const auto &workspace = static_cast<const BatchWorkspace &>(base);
+  if (optimizer_.type == Optimizer::Type::kSgd) {
+    for (std::size_t i = 0; i < weights_.size(); ++i) {
+      AxpyInto(weights_[i], -lr, workspace.weight_gradients[i]);
+      AxpyInto(biases_[i], -lr, workspace.bias_gradients[i]);
+    }
+    return;
+  }
+
+  const double samples =
+      static_cast<double>(std::max<std::size_t>(workspace.samples, 1));
+  const bool adam = optimizer_.type == Optimizer::Type::kAdam;
+  double step_lr = lr * samples;
+  if (adam) {
+    const double step = static_cast<double>(++steps_);
+    step_lr *= std::sqrt(1.0 - std::pow(optimizer_.beta2, step)) /
+               (1.0 - std::pow(optimizer_.beta1, step));
+  }
+  const BasicUpdateStep<T> step{
+      static_cast<T>(step_lr), static_cast<T>(1.0 / samples),
+      static_cast<T>(adam ? optimizer_.beta1 : optimizer_.momentum),
+      static_cast<T>(optimizer_.beta2), static_cast<T>(optimizer_.epsilon)};
+  const BasicSimdKernels<T> &kernels = GetSimdKernels<T>();
+  const auto update = adam ? kernels.adam
+                      : optimizer_.type == Optimizer::Type::kNesterov
+                          ? kernels.nesterov
+                          : kernels.momentum;
+
+  for (std::size_t i = 0; i < weights_.size(); ++i) {
+    update(workspace.weight_gradients[i].begin(), step, weights_[i].begin(),
+           first_weights_[i].begin(),
+           adam ? second_weights_[i].begin() : nullptr,
+           weights_[i].GetSize());
+    update(workspace.bias_gradients[i].begin(), step, biases_[i].begin(),
+           first_biases_[i].begin(),
+           adam ? second_biases_[i].begin() : nullptr, biases_[i].GetSize());
+  }
+}
+
+template <typename T>
+Vector BasicMatrixMlp<T>::GetOutput() const {
+  const BasicMatrix<T> &output_matrix = workspace_.values.back();
+  return Vector{output_matrix.begin(), output_matrix.end()};
+}
+
+template <typename T>
+void BasicMatrixMlp<T>::CopyOutput(Vector &output) const {
+  const BasicMatrix<T> &values = workspace_.values.back();
+  output.resize(values.GetSize());
+  std::copy(values.begin(), values.end(), output.begin());
+}
+
+template <typename T>
+LayerViews BasicMatrixMlp<T>::GetLayerViews() const {
+  std::vector<BasicLayerView<T>> layers;
+  for (std::size_t i = 0; i < weights_.size(); ++i) {
+    layers.push_back({weights_[i].GetView(), biases_[i].GetView()});
   }
+  return layers;
 }
 
-Vector MatrixMlp::GetOutput() const {
-  const Matrix &output_matrix = values_.back();
-  return Vector{output_matrix.front().cbegin(), output_matrix.front().cend()};
+template <typename T>
+void BasicMatrixMlp<T>::SetMlp(const Tensor &weights, const Tensor &biases) {
+  weights_ = ConvertLayers<T>(weights);
+  biases_ = ConvertLayers<T>(biases);
+  if (activations_.size() != weights_.size()) {
+    activations_.assign(weights_.size(), Activation::kSigmoid);
+  }
+  ResetOptimizer();
 }
 
-std::pair<const Tensor, const Tensor> MatrixMlp::GetMlp() const {
-  return {weights_, biases_};
+template <typename T>
+void BasicMatrixMlp<T>::SetOptimizer(const Optimizer &optimizer) {
+  optimizer_ = optimizer;
+  ResetOptimizer();
 }
 
-void MatrixMlp::SetMlp(const Tensor &weights, const Tensor &biases) {
-  weights_ = weights;
-  biases_ = biases;
+/**
+ * Zeroes the state of the optimizer for the current weights. The second
+ * moments are only allocated for Adam, and the model's own workspace gets
+ * gradient buffers when the optimizer needs them.
+ */
+template <typename T>
+void BasicMatrixMlp<T>::ResetOptimizer() {
+  const bool sgd = optimizer_.type == Optimizer::Type::kSgd;
+  const bool adam = optimizer_.type == Optimizer::Type::kAdam;
+  const auto zeros = [](const Layers &layers, bool used) {
+    Layers result;
+    if (!used) return result;
+    for (const BasicMatrix<T> &layer : layers) {
+      result.emplace_back(layer.GetRows(), layer.GetCols());
+      result.back().Fill(T{0});
+    }
+    return result;
+  };
+  first_weights_ = zeros(weights_, !sgd);
+  first_biases_ = zeros(biases_, !sgd);
+  second_weights_ = zeros(weights_, adam);
+  second_biases_ = zeros(biases_, adam);
+  steps_ = 0;
+  workspace_ = MakeWorkspace(!sgd);
 }
 
+template class BasicMatrixMlp<double>;
+template class BasicMatrixMlp<float>;
+
 }  // namespace s21
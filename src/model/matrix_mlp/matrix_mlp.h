@@ -1,6 +1,8 @@
 #ifndef MLP_MODEL_MATRIX_MLP_MATRIX_MLP_H_
 #define MLP_MODEL_MATRIX_MLP_MATRIX_MLP_H_
 
+#include <atomic>
+
 #include "abstract_mlp.h"
 #include "config.h"
 #include "matrix_operations.h"
@@ -8,31 +10,93 @@
 namespace s21 {
 
 /**
- * @class MatrixMlp
+ * @class BasicMatrixMlp
  * @brief Implementation of Multi-Layer Perceptron (MLP) in matrix form.
  *
- * The MatrixMlp class represents a Multi-Layer Perceptron implemented using
- * matrix operations for efficient forward and backward propagations. It
+ * The BasicMatrixMlp class represents a Multi-Layer Perceptron implemented
+ * using matrix operations for efficient forward and backward propagations. It
  * inherits from the AbstractMlp interface and provides methods for setting
  * input layers, performing forward and backward propagations, and accessing MLP
- * parameters.
+ * parameters. Weights and activations are stored and computed in the scalar
+ * type T; values crossing the AbstractMlp interface are converted to double.
+ * Once the buffers have reached the size of the batch, a train or predict
+ * step does not allocate memory as long as its products are too small to be
+ * handed to the thread pool.
  */
-class MatrixMlp : public AbstractMlp {
+template <typename T>
+class BasicMatrixMlp : public AbstractMlp {
  public:
-  explicit MatrixMlp(const Topology &);
+  using Layers = std::vector<BasicMatrix<T>>;
+
+  explicit BasicMatrixMlp(const Topology &);
 
   void SetInputLayer(const Vector &) override;
   void ForwardPropagation() override;
   void BackPropagation(const Vector &, double) override;
   Vector GetOutput() const override;
-  std::pair<const Tensor, const Tensor> GetMlp() const override;
+  void CopyOutput(Vector &) const override;
+  LayerViews GetLayerViews() const override;
   void SetMlp(const Tensor &, const Tensor &) override;
+  void SetOptimizer(const Optimizer &) override;
+  void TrainBatch(const Matrix &, const Matrix &, double, Matrix &) override;
+
+  std::unique_ptr<Workspace> CreateWorkspace() const override;
+  void ComputeGradients(const Matrix &, const Matrix &, Workspace &,
+                        Matrix &) const override;
+  void ReduceGradients(Workspace &, const Workspace &) const override;
+  void ApplyGradients(const Workspace &, double) override;
+  void TrainBatchAsync(const Matrix &, const Matrix &, double, Workspace &,
+                       Matrix &) override;
 
  private:
-  Tensor weights_;
-  Tensor biases_;
-  Tensor values_;
+  // Buffers sized from the topology, so a steady-state step does not
+  // allocate: the activations and, for the backward pass, the deltas and the
+  // activation derivatives of every layer. The gradients are only stored by
+  // the workspaces of data-parallel workers and when an optimizer other
+  // than SGD is used; the SGD step of the model accumulates the products
+  // computing them into the weights directly.
+  struct BatchWorkspace : Workspace {
+    Layers values;
+    Layers errors;
+    Layers derivatives;
+    Layers weight_gradients;
+    Layers bias_gradients;
+    // Samples summed in the gradients.
+    std::size_t samples = 0;
+    BasicMatrix<T> expected;
+    // Row of ones summing the bias gradients over a batch.
+    BasicMatrix<T> ones;
+  };
+
+  BatchWorkspace MakeWorkspace(bool gradients) const;
+  void SetBatch(const Matrix &, const Matrix &, BatchWorkspace &) const;
+  void Forward(BatchWorkspace &) const;
+  void OutputErrors(BatchWorkspace &) const;
+  void PropagateErrors(BatchWorkspace &, std::size_t layer) const;
+  void Gradients(BatchWorkspace &) const;
+  void Backward(BatchWorkspace &, double lr);
+  void ResetOptimizer();
+
+  Layers weights_;
+  Layers biases_;
+  // Activation of the output of every weight layer.
+  std::vector<Activation> activations_;
+  BatchWorkspace workspace_;
+  // State of the optimizer, shaped like the weights and the biases: the
+  // velocities or the first moments, and the second moments of Adam. The
+  // steps count the updates for the bias correction of Adam, Hogwild
+  // workers increment them concurrently.
+  Optimizer optimizer_;
+  Layers first_weights_;
+  Layers first_biases_;
+  Layers second_weights_;
+  Layers second_biases_;
+  std::atomic<std::size_t> steps_;
 };
+
+using MatrixMlp = BasicMatrixMlp<double>;
+using FloatMatrixMlp = BasicMatrixMlp<float>;
+
 }  // namespace s21
 
 #endif  // MLP_MODEL_MATRIX_MLP_MATRIX_MLP_H_
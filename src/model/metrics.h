@@ -30,7 +30,10 @@ class Metrics {
         fn_(num_classes, 0),
         loss_(0.0),
         time_(0),
-        size_(1) {}
+        size_(1),
+        workers_(0),
+        busy_time_(0.0),
+        wall_time_(0.0) {}
 
   void AddTruePositive(std::size_t label) { ++tp_[label - 1]; }
   void AddFalsePositive(std::size_t label) { ++fp_[label - 1]; }
@@ -99,11 +102,25 @@ class Metrics {
     return loss;
   }
 
+  static double GetMSE(const double* predict, const double* expect,
+                       std::size_t size) {
+    double loss = 0.0;
+    for (std::size_t i = 0; i < size; ++i) {
+      double diff = expect[i] - predict[i];
+      loss += diff * diff;
+    }
+    return loss;
+  }
+
   double GetLoss() const { return loss_ / size_; }
   void SetLoss(double loss) { loss_ = loss; }
   void AddLoss(const Vector& predict, const Vector& expect) {
     loss_ += GetMSE(predict, expect);
   }
+  void AddLoss(const double* predict, const double* expect, std::size_t size) {
+    loss_ += GetMSE(predict, expect, size);
+  }
+  void AddLoss(double loss) { loss_ += loss; }
 
   long long GetTotalTime() const { return time_; }
   void SetTime(long long time) { time_ += time; }
@@ -117,6 +134,30 @@ class Metrics {
     }
   }
 
+  // Time spent by the data-parallel workers and wall time of their steps.
+  void AddScaling(std::size_t workers, double busy, double wall) {
+    workers_ = workers;
+    busy_time_ += busy;
+    wall_time_ += wall;
+  }
+
+  // Zero when no batch was split over workers.
+  std::size_t GetWorkers() const { return workers_; }
+
+  // Average number of workers busy at once during the parallel steps, the
+  // busy time of all the workers divided by the wall time of the steps. It
+  // measures how well the work is spread, not a speedup over a serial run.
+  double GetParallelism() const {
+    if (wall_time_ <= 0.0) return 0.0;
+    return busy_time_ / wall_time_;
+  }
+
+  // Parallelism divided by the number of workers.
+  double GetScalingEfficiency() const {
+    if (workers_ == 0) return 0.0;
+    return GetParallelism() / workers_;
+  }
+
   void StartMeasure(std::size_t size) {
     Clear();
     size_ = size;
@@ -131,6 +172,9 @@ class Metrics {
     loss_ = 0.0;
     time_ = 0;
     size_ = 1;
+    workers_ = 0;
+    busy_time_ = 0.0;
+    wall_time_ = 0.0;
   }
 
   void StartTimer() { start_time_ = std::chrono::high_resolution_clock::now(); }
@@ -152,6 +196,23 @@ class Metrics {
     std::cout << "\tTotal time: " << GetTotalTime() << " seconds\n";
   }
 
+  // Compares the accuracy with the one of the model this one approximates.
+  void AccuracyDeltaReport(const Metrics& reference,
+                           const char* name = "Quantized") const {
+    std::cout << "Accuracy delta on " << size_ << " images\n";
+    std::cout << "\tReference: " << reference.GetAccuracy() << std::endl;
+    std::cout << "\t" << name << ": " << GetAccuracy() << std::endl;
+    std::cout << "\tDelta: " << GetAccuracy() - reference.GetAccuracy()
+              << std::endl;
+  }
+
+  void ScalingReport() const {
+    std::cout << "Data-parallel workers: " << workers_ << std::endl;
+    std::cout << "\tParallelism: " << GetParallelism() << std::endl;
+    std::cout << "\tScaling efficiency: " << GetScalingEfficiency()
+              << std::endl;
+  }
+
   void TrainReport(std::size_t epochs, std::size_t epoch) {
     auto end_time = std::chrono::high_resolution_clock::now();
     auto epoch_time =
@@ -172,6 +233,9 @@ class Metrics {
   double loss_;
   long long time_;
   std::size_t size_;
+  std::size_t workers_;
+  double busy_time_;
+  double wall_time_;
   std::chrono::time_point<std::chrono::high_resolution_clock> start_time_;
 };
 
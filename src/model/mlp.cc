@@ -2,6 +2,102 @@
 
 namespace s21 {
 
+namespace {
+
+// Weight files start with this tag followed by the size of the stored scalar
+// type. Files without the tag come from older versions and store doubles.
+constexpr char kWeightsTag[8] = {'S', '2', '1', 'M', 'L', 'P', 'W', '\0'};
+
+// Rows of a strided view buffered by a write.
+constexpr std::size_t kWriteRows = 64;
+
+// Writes the elements of a view row by row: in a single write when it is
+// contiguous, otherwise through a buffer of kWriteRows rows, filled column by
+// column so a transposed view is read along its storage.
+template <typename T>
+void WriteView(std::ofstream& file, BasicMatrixView<const T> view) {
+  if (view.IsContiguous()) {
+    file.write(reinterpret_cast<const char*>(view.Data()),
+               sizeof(T) * view.GetRows() * view.GetCols());
+    return;
+  }
+  const std::size_t cols = view.GetCols();
+  std::vector<T> rows(std::min(kWriteRows, view.GetRows()) * cols);
+  for (std::size_t begin = 0; begin < view.GetRows(); begin += kWriteRows) {
+    const std::size_t count = std::min(kWriteRows, view.GetRows() - begin);
+    for (std::size_t j = 0; j < cols; ++j) {
+      for (std::size_t i = 0; i < count; ++i) {
+        rows[i * cols + j] = view(begin + i, j);
+      }
+    }
+    file.write(reinterpret_cast<const char*>(rows.data()),
+               sizeof(T) * count * cols);
+  }
+}
+
+template <typename T>
+void ReadValues(std::ifstream& file, Matrix& matrix) {
+  std::vector<T> values(matrix.GetSize());
+  file.read(reinterpret_cast<char*>(values.data()),
+            sizeof(T) * values.size());
+  std::copy(values.begin(), values.end(), matrix.begin());
+}
+
+/**
+ * Writes the tag, the size of the scalar type, the number of layers and the
+ * dimensions, the weights and the biases of every layer.
+ */
+template <typename T>
+void WriteLayers(std::ofstream& file,
+                 const std::vector<BasicLayerView<T>>& layers) {
+  file.write(kWeightsTag, sizeof(kWeightsTag));
+  const std::size_t scalar_size = sizeof(T);
+  file.write(reinterpret_cast<const char*>(&scalar_size), sizeof(scalar_size));
+  const std::size_t num_layers = layers.size();
+  file.write(reinterpret_cast<const char*>(&num_layers), sizeof(num_layers));
+
+  for (const BasicLayerView<T>& layer : layers) {
+    const std::size_t rows = layer.weights.GetRows();
+    const std::size_t cols = layer.weights.GetCols();
+    file.write(reinterpret_cast<const char*>(&rows), sizeof(rows));
+    file.write(reinterpret_cast<const char*>(&cols), sizeof(cols));
+    WriteView(file, layer.weights);
+    WriteView(file, layer.biases);
+  }
+}
+
+void ReadMatrix(std::ifstream& file, Matrix& matrix, std::size_t scalar_size) {
+  if (scalar_size == sizeof(float)) {
+    ReadValues<float>(file, matrix);
+  } else {
+    ReadValues<double>(file, matrix);
+  }
+}
+
+void FillBatch(const Dataset& dataset, std::size_t begin, std::size_t end,
+               std::size_t outputs, Matrix& inputs, Matrix& expected) {
+  inputs.Resize(end - begin, dataset[begin].GetPixels().size());
+  expected.Resize(end - begin, outputs);
+  expected.Fill(0.0);
+  for (std::size_t i = begin; i < end; ++i) {
+    const Vector& pixels = dataset[i].GetPixels();
+    std::copy(pixels.begin(), pixels.end(), inputs[i - begin]);
+    expected(i - begin, dataset[i].GetLabel() - 1) = 1.0;
+  }
+}
+
+std::mt19937 MakeGenerator(unsigned seed) {
+  return std::mt19937(seed ? seed : std::random_device{}());
+}
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+}  // namespace
+
 MLP::MLP(const Topology& topology)
     : topology_{topology}, metrics_{topology_.GetOutputSize()} {
   mlp_ = std::make_unique<MatrixMlp>(topology_);
@@ -19,42 +115,224 @@ void MLP::Train() {
     case Config::TrainType::kCrossValidation:
       CrossValidate();
       break;
+    case Config::TrainType::kHogwild:
+      TrainHogwild();
+      break;
     default:
       throw std::runtime_error("Invalid training type.");
   }
 }
 
+/**
+ * Trains one epoch in batches. With several threads every batch is split
+ * over at most one worker per sample, so the workers are capped by the batch
+ * size and a batch size of 1 trains serially.
+ *
+ * @param train The dataset.
+ */
 void MLP::TrainEpoch(const Dataset& train) {
+  const std::size_t batch_size =
+      std::max<std::size_t>(config_.GetBatchSize(), 1);
   std::size_t percent = static_cast<std::size_t>(train.size() / 100.0);
+  const std::size_t workers = std::min(config_.GetThreads(), batch_size);
+  Workspaces workspaces;
+  if (workers > 1) {
+    workspaces = CreateWorkspaces(workers);
+  }
+  std::vector<Batch> shards(std::max<std::size_t>(workspaces.size(), 1));
+  std::vector<double> busy(workspaces.size(), 0.0);
+  double wall = 0.0;
+
+  for (std::size_t begin = 0; begin < train.size(); begin += batch_size) {
+    const std::size_t end = std::min(begin + batch_size, train.size());
+    if (workspaces.empty()) {
+      Batch& batch = shards.front();
+      FillBatch(train, begin, end, topology_.GetOutputSize(), batch.inputs,
+                batch.expected);
+      mlp_->TrainBatch(batch.inputs, batch.expected,
+                       config_.GetLearningRate(), batch.outputs);
+    } else {
+      const auto start = std::chrono::steady_clock::now();
+      TrainShards(train, begin, end, workspaces, shards, busy);
+      wall += SecondsSince(start);
+    }
 
-  for (std::size_t i = 0; i < train.size(); ++i) {
-    mlp_->SetInputLayer(train[i].GetPixels());
-    mlp_->ForwardPropagation();
-    const Vector expected_output = ExpectedOutput(train[i]);
-    mlp_->BackPropagation(expected_output, config_.GetLearningRate());
-    metrics_.AddLoss(mlp_->GetOutput(), expected_output);
+    for (const Batch& batch : shards) {
+      for (std::size_t row = 0; row < batch.outputs.GetRows(); ++row) {
+        metrics_.AddLoss(batch.outputs[row], batch.expected[row],
+                         batch.outputs.GetCols());
+      }
+    }
+    for (std::size_t i = begin; i < end; ++i) {
+      if (i % percent == 0) {
+        ptr_progress_((i / percent) + 1);
+      }
+    }
+  }
 
-    if (i % percent == 0) {
-      ptr_progress_((i / percent) + 1);
+  if (!workspaces.empty()) {
+    metrics_.AddScaling(workspaces.size(),
+                        std::accumulate(busy.begin(), busy.end(), 0.0), wall);
+  }
+}
+
+/**
+ * Returns the pool running the data-parallel and Hogwild workers, with one
+ * thread less than the configured threads since the calling thread works
+ * too. It is owned by the model and recreated when the threads change, so
+ * training never resizes the shared pool other code may be using. The
+ * kernels called by the workers run serially, as nested parallel loops.
+ *
+ * @return The pool of the workers.
+ */
+ThreadPool& MLP::GetWorkerPool() {
+  const std::size_t threads =
+      std::max<std::size_t>(config_.GetThreads(), 1) - 1;
+  if (!workers_ or workers_->GetThreadsCount() != threads) {
+    workers_ = std::make_unique<ThreadPool>(threads);
+  }
+  return *workers_;
+}
+
+/**
+ * Creates one workspace per worker.
+ *
+ * @param count The number of workers.
+ * @return The workspaces, empty when the model does not support them.
+ */
+MLP::Workspaces MLP::CreateWorkspaces(std::size_t count) {
+  Workspaces workspaces;
+  for (std::size_t i = 0; i < count; ++i) {
+    std::unique_ptr<Workspace> workspace = mlp_->CreateWorkspace();
+    if (!workspace) return {};
+    workspaces.push_back(std::move(workspace));
+  }
+  return workspaces;
+}
+
+/**
+ * Trains on a batch split into contiguous shards, one per worker. Every
+ * worker computes the gradients of its shard in its own workspace, then the
+ * workspaces are summed pairwise along a binary tree into the first one,
+ * which is applied once. The shards and the order of the sums only depend on
+ * the number of workers, so the result is reproducible for a given seed,
+ * thread count and batch size.
+ *
+ * @param train The dataset.
+ * @param begin The index of the first sample of the batch.
+ * @param end The index past the last sample of the batch.
+ * @param workspaces The workspaces of the workers.
+ * @param shards The samples and outputs of the shards.
+ * @param busy Accumulates the time spent by every worker, in seconds.
+ */
+void MLP::TrainShards(const Dataset& train, std::size_t begin,
+                      std::size_t end, Workspaces& workspaces,
+                      std::vector<Batch>& shards, std::vector<double>& busy) {
+  const std::size_t count = end - begin;
+  const std::size_t used = std::min(workspaces.size(), count);
+  ThreadPool& pool = GetWorkerPool();
+
+  pool.ParallelFor(shards.size(), [&](std::size_t w) {
+    Batch& shard = shards[w];
+    if (w >= used) {
+      shard.outputs.Resize(0, topology_.GetOutputSize());
+      return;
     }
+    const auto start = std::chrono::steady_clock::now();
+    FillBatch(train, begin + count * w / used, begin + count * (w + 1) / used,
+              topology_.GetOutputSize(), shard.inputs, shard.expected);
+    mlp_->ComputeGradients(shard.inputs, shard.expected, *workspaces[w],
+                           shard.outputs);
+    busy[w] += SecondsSince(start);
+  });
+
+  for (std::size_t stride = 1; stride < used; stride *= 2) {
+    pool.ParallelFor((used + 2 * stride - 1) / (2 * stride),
+                     [&](std::size_t pair) {
+                       const std::size_t w = pair * 2 * stride;
+                       if (w + stride < used) {
+                         mlp_->ReduceGradients(*workspaces[w],
+                                               *workspaces[w + stride]);
+                       }
+                     });
   }
+  mlp_->ApplyGradients(*workspaces.front(),
+                       config_.GetLearningRate() / static_cast<double>(count));
 }
 
 void MLP::TrainEpochs() {
   double percent = static_cast<double>(100.0 / config_.GetEpochs());
 
   metrics_.StartMeasure(train_.size());
+  std::mt19937 gen = MakeGenerator(config_.GetSeed());
   for (std::size_t epoch = 0; epoch < config_.GetEpochs(); ++epoch) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
     std::shuffle(train_.begin(), train_.end(), gen);
 
     TrainEpoch(train_);
 
+    if (config_.GetVerbose()) {
+      metrics_.TrainReport(config_.GetEpochs(), epoch);
+      if (metrics_.GetWorkers() > 0) metrics_.ScalingReport();
+    }
+
+    ptr_full_progress_((epoch * percent) + percent);
+    ptr_metrics_(metrics_);
+    metrics_.SetLoss(0);
+  }
+}
+
+/**
+ * Hogwild training. Every epoch the shuffled dataset is split into one
+ * contiguous slice per thread and the threads train on their slices at the
+ * same time, each with its own activations, applying their updates to the
+ * shared weights without locks. The result depends on the interleaving of
+ * the threads, so it is not reproducible. Models without workspaces are
+ * trained sequentially.
+ */
+void MLP::TrainHogwild() {
+  Workspaces workspaces =
+      CreateWorkspaces(std::max<std::size_t>(config_.GetThreads(), 1));
+  if (workspaces.empty()) {
+    TrainEpochs();
+    return;
+  }
+  const std::size_t batch_size =
+      std::max<std::size_t>(config_.GetBatchSize(), 1);
+  const std::size_t workers = workspaces.size();
+  double percent = static_cast<double>(100.0 / config_.GetEpochs());
+  std::vector<Batch> batches(workers);
+  std::vector<double> losses(workers);
+
+  metrics_.StartMeasure(train_.size());
+  std::mt19937 gen = MakeGenerator(config_.GetSeed());
+  for (std::size_t epoch = 0; epoch < config_.GetEpochs(); ++epoch) {
+    std::shuffle(train_.begin(), train_.end(), gen);
+    std::fill(losses.begin(), losses.end(), 0.0);
+
+    GetWorkerPool().ParallelFor(workers, [&](std::size_t w) {
+      const std::size_t first = train_.size() * w / workers;
+      const std::size_t last = train_.size() * (w + 1) / workers;
+      Batch& batch = batches[w];
+      for (std::size_t begin = first; begin < last; begin += batch_size) {
+        const std::size_t end = std::min(begin + batch_size, last);
+        FillBatch(train_, begin, end, topology_.GetOutputSize(), batch.inputs,
+                  batch.expected);
+        mlp_->TrainBatchAsync(batch.inputs, batch.expected,
+                              config_.GetLearningRate(), *workspaces[w],
+                              batch.outputs);
+        for (std::size_t row = 0; row < batch.outputs.GetRows(); ++row) {
+          losses[w] += Metrics::GetMSE(batch.outputs[row], batch.expected[row],
+                                       batch.outputs.GetCols());
+        }
+      }
+    });
+    metrics_.AddLoss(std::accumulate(losses.begin(), losses.end(), 0.0));
+
     if (config_.GetVerbose()) {
       metrics_.TrainReport(config_.GetEpochs(), epoch);
     }
 
+    ptr_progress_(100);
     ptr_full_progress_((epoch * percent) + percent);
     ptr_metrics_(metrics_);
     metrics_.SetLoss(0);
@@ -155,13 +433,77 @@ std::size_t MLP::PredictLabel(const Image& image) {
   return std::distance(predicted.begin(), it) + 1;
 }
 
-void MLP::SetType(Config::ModelType type) {
-  config_.SetModelType(type);
+/**
+ * Builds a model of a type and a precision with the configured optimizer and
+ * math mode, without touching the current model or the configuration.
+ *
+ * @param type The type of the model.
+ * @param precision The scalar type of the matrix model.
+ * @return The new model.
+ * @throws std::invalid_argument If there is no static model for the topology.
+ * @throws std::logic_error If the model only supports SGD and another
+ * optimizer is configured.
+ */
+std::unique_ptr<AbstractMlp> MLP::MakeModel(
+    Config::ModelType type, Config::Precision precision) const {
+  std::unique_ptr<AbstractMlp> mlp;
   if (type == Config::ModelType::kMatrix) {
-    mlp_ = std::make_unique<MatrixMlp>(topology_);
+    if (precision == Config::Precision::kFloat) {
+      mlp = std::make_unique<FloatMatrixMlp>(topology_);
+    } else {
+      mlp = std::make_unique<MatrixMlp>(topology_);
+    }
   } else if (type == Config::ModelType::kGraph) {
-    mlp_ = std::make_unique<GraphMlp>(topology_);
+    mlp = std::make_unique<GraphMlp>(topology_);
+  } else if (type == Config::ModelType::kQuantized) {
+    mlp = std::make_unique<QuantizedMlp>(topology_);
+  } else if (type == Config::ModelType::kStatic) {
+    mlp = MakeStaticMlp(topology_);
+  }
+  mlp->SetMathMode(config_.GetMathMode());
+  if (config_.GetOptimizer().type != Optimizer::Type::kSgd) {
+    mlp->SetOptimizer(config_.GetOptimizer());
   }
+  return mlp;
+}
+
+/**
+ * Replaces the model by a new one of a type. The model is built before the
+ * configuration changes, so a type that cannot be built leaves the current
+ * model in place.
+ *
+ * @param type The type of the new model.
+ */
+void MLP::SetType(Config::ModelType type) {
+  mlp_ = MakeModel(type, config_.GetPrecision());
+  config_.SetModelType(type);
+}
+
+void MLP::SetOptimizer(const Optimizer& optimizer) {
+  mlp_->SetOptimizer(optimizer);
+  config_.SetOptimizer(optimizer);
+}
+
+void MLP::SetSeed(unsigned seed) {
+  config_.SetSeed(seed);
+  if (seed) SeedRandomWeights(seed);
+}
+
+void MLP::SetMathMode(MathMode mode) {
+  config_.SetMathMode(mode);
+  mlp_->SetMathMode(mode);
+}
+
+// Rebuilds the model in the new precision with the same weights, the
+// configuration only changes once the new model is complete.
+void MLP::SetPrecision(Config::Precision precision) {
+  if (precision == config_.GetPrecision()) return;
+  const auto [weights, biases] = mlp_->GetMlp();
+  std::unique_ptr<AbstractMlp> mlp =
+      MakeModel(config_.GetModelType(), precision);
+  mlp->SetMlp(weights, biases);
+  mlp_ = std::move(mlp);
+  config_.SetPrecision(precision);
 }
 
 void MLP::Save(const std::string& path) {
@@ -171,49 +513,55 @@ void MLP::Save(const std::string& path) {
     throw std::runtime_error("Failed to open file: " + ss.str());
   }
 
-  const auto& [weights, biases] = mlp_->GetMlp();
-
-  // Write the number of layers
-  std::size_t num_layers = weights.size();
-  file.write(reinterpret_cast<const char*>(&num_layers), sizeof(num_layers));
-
-  for (std::size_t i = 0; i < num_layers; ++i) {
-    const Matrix& layer_weights = weights[i];
-    const Matrix& layer_biases = biases[i];
-
-    // Write the dimensions of the weight matrix
-    std::size_t rows = layer_weights.size();
-    std::size_t cols = layer_weights[0].size();
-    file.write(reinterpret_cast<const char*>(&rows), sizeof(rows));
-    file.write(reinterpret_cast<const char*>(&cols), sizeof(cols));
-
-    // Write the weight matrix
-    for (const Vector& row : layer_weights) {
-      file.write(reinterpret_cast<const char*>(row.data()),
-                 sizeof(double) * cols);
-    }
-
-    // Write the bias vector
-    for (const Vector& bias : layer_biases) {
-      file.write(reinterpret_cast<const char*>(bias.data()),
-                 sizeof(double) * bias.size());
-    }
+  // The layers are written from views of the model, in the scalar type it
+  // stores, without copying it
+  const LayerViews views = mlp_->GetLayerViews();
+  std::visit([&](const auto& layers) { WriteLayers(file, layers); }, views);
+  const std::size_t num_layers =
+      std::visit([](const auto& layers) { return layers.size(); }, views);
+
+  // Write the activations of the layers after the weights, so older versions
+  // still read the file
+  for (std::size_t i = 1; i <= num_layers; ++i) {
+    const std::size_t activation =
+        static_cast<std::size_t>(topology_.GetActivation(i));
+    file.write(reinterpret_cast<const char*>(&activation),
+               sizeof(activation));
   }
 }
 
-void MLP::Load(const std::string& path) {
+/**
+ * Reads a file written by MLP::Save, or by older versions without the tag
+ * or the activations.
+ *
+ * @param path The path of the file.
+ * @return The weights, the biases and the activations of the layers.
+ * @throws std::runtime_error If the file can't be opened or stores an
+ * unsupported scalar type or activation.
+ */
+WeightsFile ReadWeightsFile(const std::string& path) {
   std::ifstream file(path, std::ios::binary);
   if (!file.is_open()) {
     throw std::runtime_error("Failed to open file: " + path);
   }
 
-  // Read the number of layers
+  // Files without the tag start with the number of layers and store doubles
+  char tag[sizeof(kWeightsTag)];
+  std::size_t scalar_size = sizeof(double);
   std::size_t num_layers;
-  file.read(reinterpret_cast<char*>(&num_layers), sizeof(num_layers));
+  file.read(tag, sizeof(tag));
+  if (std::equal(tag, tag + sizeof(tag), kWeightsTag)) {
+    file.read(reinterpret_cast<char*>(&scalar_size), sizeof(scalar_size));
+    if (scalar_size != sizeof(float) and scalar_size != sizeof(double)) {
+      throw std::runtime_error("Unsupported scalar size in file: " + path);
+    }
+    file.read(reinterpret_cast<char*>(&num_layers), sizeof(num_layers));
+  } else {
+    std::copy(tag, tag + sizeof(tag), reinterpret_cast<char*>(&num_layers));
+  }
 
   // Read each layer's weights and biases
-  Tensor weights(num_layers);
-  Tensor biases(num_layers);
+  WeightsFile result{Tensor(num_layers), Tensor(num_layers), {}};
   for (std::size_t i = 0; i < num_layers; ++i) {
     // Read the dimensions of the weight matrix
     std::size_t rows, cols;
@@ -221,28 +569,49 @@ void MLP::Load(const std::string& path) {
     file.read(reinterpret_cast<char*>(&cols), sizeof(cols));
 
     // Read the weight matrix
-    Matrix layer_weights(rows, Vector(cols));
-    for (Vector& row : layer_weights) {
-      file.read(reinterpret_cast<char*>(row.data()), sizeof(double) * cols);
-    }
-    weights[i] = std::move(layer_weights);
+    Matrix layer_weights(rows, cols);
+    ReadMatrix(file, layer_weights, scalar_size);
+    result.weights[i] = std::move(layer_weights);
 
     // Read the bias matrix
-    Matrix layer_biases(1, Vector(cols));
-    file.read(reinterpret_cast<char*>(layer_biases[0].data()),
-              sizeof(double) * cols);
-    biases[i] = std::move(layer_biases);
+    Matrix layer_biases(1, cols);
+    ReadMatrix(file, layer_biases, scalar_size);
+    result.biases[i] = std::move(layer_biases);
   }
 
-  UpdateMlp(weights, biases);
+  // Files without the activations use the sigmoid everywhere
+  result.activations.assign(num_layers, Activation::kSigmoid);
+  for (Activation& activation : result.activations) {
+    std::size_t value;
+    if (!file.read(reinterpret_cast<char*>(&value), sizeof(value))) break;
+    if (value > static_cast<std::size_t>(Activation::kRelu)) {
+      throw std::runtime_error("Unsupported activation in file: " + path);
+    }
+    activation = static_cast<Activation>(value);
+  }
+  return result;
+}
+
+void MLP::Load(const std::string& path) {
+  const WeightsFile file = ReadWeightsFile(path);
+
+  std::vector<std::size_t> layer_sizes{file.weights[0].GetRows()};
+  for (const auto& layer : file.weights) {
+    layer_sizes.push_back(layer.GetCols());
+  }
+  topology_.SetTopology(layer_sizes);
+  for (std::size_t i = 0; i < file.activations.size(); ++i) {
+    topology_.SetActivation(file.activations[i], i + 1);
+  }
+  UpdateMlp(file.weights, file.biases);
 }
 
 void MLP::UpdateMlp(const Tensor& weights, const Tensor& biases) {
   std::vector<std::size_t> layer_sizes;
-  layer_sizes.push_back(weights[0].size());
+  layer_sizes.push_back(weights[0].GetRows());
 
   for (const auto& layer : weights) {
-    layer_sizes.push_back(layer[0].size());
+    layer_sizes.push_back(layer.GetCols());
   }
 
   topology_.SetTopology(layer_sizes);
@@ -251,6 +620,53 @@ void MLP::UpdateMlp(const Tensor& weights, const Tensor& biases) {
   metrics_ = Metrics{topology_.GetOutputSize()};
 }
 
+/**
+ * Replaces the model by its int8 quantized version. The activation ranges
+ * are calibrated on the first images of the test dataset, then both models
+ * are tested and the change of accuracy is reported. A quantized model is
+ * calibrated again against the double model built from its weights.
+ *
+ * @param calibration_sample Part of the test dataset used for calibration.
+ * @return The accuracy of the quantized model minus the reference one.
+ * @throws std::runtime_error If the test dataset is not loaded.
+ */
+double MLP::Quantize(double calibration_sample) {
+  if (test_.empty()) {
+    throw std::runtime_error("Test dataset not loaded.");
+  }
+
+  const auto [weights, biases] = mlp_->GetMlp();
+  if (config_.GetModelType() == Config::ModelType::kQuantized) {
+    SetType(Config::ModelType::kMatrix);
+    mlp_->SetMlp(weights, biases);
+  }
+  Test(test_);
+  const Metrics reference = metrics_;
+
+  auto quantized = std::make_unique<QuantizedMlp>(topology_);
+  quantized->SetMlp(weights, biases);
+  quantized->SetMathMode(config_.GetMathMode());
+  const std::size_t count = std::clamp<std::size_t>(
+      static_cast<std::size_t>(test_.size() * calibration_sample), 1,
+      test_.size());
+  quantized->Calibrate(Dataset(test_.begin(), test_.begin() + count));
+  config_.SetModelType(Config::ModelType::kQuantized);
+  mlp_ = std::move(quantized);
+
+  Test(test_);
+  if (config_.GetVerbose()) {
+    metrics_.AccuracyDeltaReport(reference);
+  }
+  return metrics_.GetAccuracy() - reference.GetAccuracy();
+}
+
+void MLP::SetHiddenActivation(Activation activation) {
+  const auto [weights, biases] = mlp_->GetMlp();
+  topology_.SetHiddenActivation(activation);
+  SetType(config_.GetModelType());
+  mlp_->SetMlp(weights, biases);
+}
+
 void MLP::UpdateTopology(std::size_t hidden, std::size_t size) {
   std::vector<std::size_t> layer_sizes;
   layer_sizes.push_back(topology_.GetInputSize());
@@ -6,9 +6,20 @@
 #include "io.h"
 #include "matrix_mlp.h"
 #include "metrics.h"
+#include "quantized_mlp.h"
+#include "static_mlp.h"
 
 namespace s21 {
 
+// Contents of a weight file written by MLP::Save.
+struct WeightsFile {
+  Tensor weights;
+  Tensor biases;
+  std::vector<Activation> activations;
+};
+
+WeightsFile ReadWeightsFile(const std::string&);
+
 /**
  * @class MLP
  * @brief Multi-Layer Perceptron (MLP).
@@ -30,6 +41,10 @@ class MLP {
   void Load(const std::string&);
   void UpdateMlp(const Tensor&, const Tensor&);
   void UpdateTopology(std::size_t hidden, std::size_t size);
+  // Rebuilds the model with the activation on every hidden layer, keeping
+  // the weights.
+  void SetHiddenActivation(Activation);
+  double Quantize(double calibration_sample = 0.1);
 
   void SetTrainDataset(const std::string& path) { train_ = ParseEmnist(path); }
   void SetTrainDataset(const Dataset& dataset) { train_ = dataset; };
@@ -40,6 +55,8 @@ class MLP {
   double GetTestSample() const { return config_.GetTestSample(); }
   Config::ModelType GetType() const { return config_.GetModelType(); }
   void SetType(Config::ModelType);
+  Config::Precision GetPrecision() const { return config_.GetPrecision(); }
+  void SetPrecision(Config::Precision);
   std::size_t GetTrainDatasetSize() { return train_.size(); }
   std::size_t GetTestDatasetSize() { return test_.size(); }
   Topology& GetTopology() { return topology_; }
@@ -48,7 +65,18 @@ class MLP {
   void SetVerbose(bool verbose) { config_.SetVerbose(verbose); }
   void SetTrainType(Config::TrainType type) { config_.SetTrainType(type); }
   void SetEpochs(std::size_t epochs) { config_.SetEpochs(epochs); }
+  std::size_t GetBatchSize() const { return config_.GetBatchSize(); }
+  void SetBatchSize(std::size_t size) { config_.SetBatchSize(size); }
+  std::size_t GetThreads() const { return config_.GetThreads(); }
+  void SetThreads(std::size_t threads) { config_.SetThreads(threads); }
+  unsigned GetSeed() const { return config_.GetSeed(); }
+  void SetSeed(unsigned);
+  MathMode GetMathMode() const { return config_.GetMathMode(); }
+  void SetMathMode(MathMode);
   void SetLearningRate(double rate) { config_.SetLearningRate(rate); }
+  const Optimizer& GetOptimizer() const { return config_.GetOptimizer(); }
+  // Also resets the state of the optimizer, e.g. the velocities.
+  void SetOptimizer(const Optimizer&);
   void SetTestSample(double sample) { config_.SetTestSample(sample); }
   void SetKFolds(std::size_t k_folds) { config_.SetKFolds(k_folds); }
 
@@ -59,8 +87,23 @@ class MLP {
   }
 
  private:
+  // Samples of one batch or of one shard of it, with the computed outputs.
+  struct Batch {
+    Matrix inputs;
+    Matrix expected;
+    Matrix outputs;
+  };
+  using Workspaces = std::vector<std::unique_ptr<Workspace>>;
+
   Vector ExpectedOutput(const Image&);
   void TrainEpoch(const Dataset&);
+  void TrainShards(const Dataset&, std::size_t, std::size_t, Workspaces&,
+                   std::vector<Batch>&, std::vector<double>&);
+  ThreadPool& GetWorkerPool();
+  Workspaces CreateWorkspaces(std::size_t);
+  std::unique_ptr<AbstractMlp> MakeModel(Config::ModelType,
+                                         Config::Precision) const;
+  void TrainHogwild();
   void TrainEpochs();
   void Test(const Dataset&);
   void CrossValidate();
@@ -72,6 +115,8 @@ class MLP {
   Config config_;
   Topology topology_;
   std::unique_ptr<AbstractMlp> mlp_;
+  // Threads of the data-parallel and Hogwild training.
+  std::unique_ptr<ThreadPool> workers_;
   Dataset train_;
   Dataset test_;
   Metrics metrics_;
@@ -0,0 +1,29 @@
+#ifndef MLP_MODEL_OPTIMIZER_H_
+#define MLP_MODEL_OPTIMIZER_H_
+
+namespace s21 {
+
+/**
+ * @struct Optimizer
+ * @brief Update rule of the weights and its hyperparameters.
+ *
+ * kSgd subtracts the scaled gradients. kMomentum and kNesterov keep a
+ * velocity v = momentum * v + g per parameter and subtract lr * v, or
+ * lr * (g + momentum * v) for the Nesterov look-ahead. kAdam keeps moving
+ * averages of the gradients and of their squares and divides the first one
+ * by the square root of the second, both corrected for their zero start.
+ * The gradients of a batch are averaged over its samples first.
+ */
+struct Optimizer {
+  enum class Type { kSgd, kMomentum, kNesterov, kAdam };
+
+  Type type = Type::kSgd;
+  double momentum = 0.9;
+  double beta1 = 0.9;
+  double beta2 = 0.999;
+  double epsilon = 1e-8;
+};
+
+}  // namespace s21
+
+#endif  // MLP_MODEL_OPTIMIZER_H_
@@ -0,0 +1,180 @@
+#include "quantized_mlp.h"
+
+namespace s21 {
+
+namespace {
+
+// Range of the network inputs and of the sigmoid outputs.
+constexpr double kDefaultRange = 1.0;
+// Shift making the outputs of tanh layers non-negative.
+constexpr double kTanhOffset = 1.0;
+constexpr double kMaxWeight = 127.0;
+
+std::size_t PaddedSize(std::size_t size) {
+  return (size + kMatrixAlignment - 1) / kMatrixAlignment * kMatrixAlignment;
+}
+
+}  // namespace
+
+QuantizedMlp::QuantizedMlp(const Topology &topology)
+    : weights_(topology.GetLayersCount() - 1),
+      biases_(topology.GetLayersCount() - 1),
+      activations_(topology.GetLayersCount() - 1) {
+  for (std::size_t i = 0; i < topology.GetLayersCount() - 1; ++i) {
+    activations_[i] = topology.GetActivation(i + 1);
+    weights_[i] =
+        Matrix(topology.GetLayerSize(i), topology.GetLayerSize(i + 1));
+    RandomizeMatrix(weights_[i]);
+    biases_[i] = Matrix(1, topology.GetLayerSize(i + 1));
+    RandomizeMatrix(biases_[i]);
+  }
+  ResetRanges();
+  Quantize();
+}
+
+/**
+ * @param layer The index of a weight layer.
+ * @return The shift added to the inputs of the layer before quantization.
+ */
+double QuantizedMlp::InputOffset(std::size_t layer) const {
+  return layer > 0 and activations_[layer - 1] == Activation::kTanh
+             ? kTanhOffset
+             : 0.0;
+}
+
+void QuantizedMlp::ResetRanges() {
+  ranges_.resize(weights_.size());
+  for (std::size_t l = 0; l < ranges_.size(); ++l) {
+    ranges_[l] = kDefaultRange + InputOffset(l);
+  }
+}
+
+/**
+ * Quantizes the double weights with the current activation ranges. Every
+ * output neuron gets its own weight scale, so a neuron with small weights
+ * keeps its precision next to one with large weights.
+ */
+void QuantizedMlp::Quantize() {
+  layers_.resize(weights_.size());
+  for (std::size_t l = 0; l < weights_.size(); ++l) {
+    const Matrix &weights = weights_[l];
+    Layer &layer = layers_[l];
+    layer.inputs = weights.GetRows();
+    layer.outputs = weights.GetCols();
+    layer.stride = PaddedSize(layer.inputs);
+    layer.weights.assign(layer.outputs * layer.stride, 0);
+    layer.weight_scales.assign(layer.outputs, 1.0);
+    layer.weight_sums.assign(layer.outputs, 0);
+    layer.input_scale = ranges_[l] / kMaxDotU8;
+    layer.input_offset = InputOffset(l);
+
+    for (std::size_t j = 0; j < layer.outputs; ++j) {
+      double max_weight = 0.0;
+      for (std::size_t k = 0; k < layer.inputs; ++k) {
+        max_weight = std::max(max_weight, std::fabs(weights(k, j)));
+      }
+      if (max_weight == 0.0) continue;
+      const double scale = max_weight / kMaxWeight;
+      layer.weight_scales[j] = scale;
+      std::int8_t *row = layer.weights.data() + j * layer.stride;
+      for (std::size_t k = 0; k < layer.inputs; ++k) {
+        row[k] = static_cast<std::int8_t>(std::lround(weights(k, j) / scale));
+        layer.weight_sums[j] += row[k];
+      }
+    }
+  }
+}
+
+/**
+ * Measures the range of the inputs of every layer by running the double
+ * model on the images and quantizes the weights again with these ranges.
+ *
+ * @param dataset The calibration images, usually a slice of the test set.
+ * @throws std::invalid_argument If the dataset is empty.
+ */
+void QuantizedMlp::Calibrate(const Dataset &dataset) {
+  if (dataset.empty()) {
+    throw std::invalid_argument("Calibration dataset is empty");
+  }
+
+  Vector ranges(weights_.size(), 0.0);
+  Matrix values, next;
+  for (const Image &image : dataset) {
+    const Vector &pixels = image.GetPixels();
+    values.Resize(1, pixels.size());
+    std::copy(pixels.begin(), pixels.end(), values.begin());
+    for (std::size_t l = 0; l < weights_.size(); ++l) {
+      ranges[l] = std::max(ranges[l], *std::max_element(values.begin(),
+                                                         values.end()) +
+                                          InputOffset(l));
+      ActivateLayer(values, weights_[l], biases_[l], activations_[l], next,
+                    math_mode_);
+      std::swap(values, next);
+    }
+  }
+
+  for (std::size_t l = 0; l < ranges.size(); ++l) {
+    ranges_[l] = ranges[l] > 0.0 ? ranges[l] : kDefaultRange + InputOffset(l);
+  }
+  Quantize();
+}
+
+void QuantizedMlp::SetInputLayer(const Vector &input) { values_ = input; }
+
+void QuantizedMlp::ForwardPropagation() {
+  const SimdKernels &kernels = GetSimdKernels();
+  for (std::size_t l = 0; l < layers_.size(); ++l) {
+    const Layer &layer = layers_[l];
+    input_.assign(layer.stride, 0);
+    const double inverse_scale = 1.0 / layer.input_scale;
+    for (std::size_t k = 0; k < layer.inputs; ++k) {
+      const double value =
+          std::lround((values_[k] + layer.input_offset) * inverse_scale);
+      input_[k] = static_cast<std::uint8_t>(
+          std::clamp(value, 0.0, static_cast<double>(kMaxDotU8)));
+    }
+
+    output_.resize(layer.outputs);
+    for (std::size_t j = 0; j < layer.outputs; ++j) {
+      const std::int32_t sum = kernels.dot_u8s8(
+          input_.data(), layer.weights.data() + j * layer.stride, layer.stride);
+      output_[j] = (sum * layer.input_scale -
+                    layer.input_offset * layer.weight_sums[j]) *
+                       layer.weight_scales[j] +
+                   biases_[l](0, j);
+    }
+    ActivationKernel(activations_[l], kernels, math_mode_)(
+        output_.data(), output_.data(), output_.size());
+    std::swap(values_, output_);
+  }
+}
+
+/**
+ * @throws std::logic_error Always, the quantized model can not be trained.
+ */
+void QuantizedMlp::BackPropagation(const Vector &, double) {
+  throw std::logic_error("Quantized model is inference only");
+}
+
+Vector QuantizedMlp::GetOutput() const { return values_; }
+
+// Views of the weights in double precision the model was quantized from.
+LayerViews QuantizedMlp::GetLayerViews() const {
+  std::vector<LayerView> layers;
+  for (std::size_t i = 0; i < weights_.size(); ++i) {
+    layers.push_back({weights_[i].GetView(), biases_[i].GetView()});
+  }
+  return layers;
+}
+
+void QuantizedMlp::SetMlp(const Tensor &weights, const Tensor &biases) {
+  weights_ = weights;
+  biases_ = biases;
+  if (activations_.size() != weights_.size()) {
+    activations_.assign(weights_.size(), Activation::kSigmoid);
+  }
+  ResetRanges();
+  Quantize();
+}
+
+}  // namespace s21
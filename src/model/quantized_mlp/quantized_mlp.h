@@ -0,0 +1,78 @@
+#ifndef MLP_MODEL_QUANTIZED_MLP_QUANTIZED_MLP_H_
+#define MLP_MODEL_QUANTIZED_MLP_QUANTIZED_MLP_H_
+
+#include <cstdint>
+
+#include "abstract_mlp.h"
+#include "config.h"
+#include "io.h"
+#include "matrix_operations.h"
+
+namespace s21 {
+
+/**
+ * @class QuantizedMlp
+ * @brief Inference-only Multi-Layer Perceptron with 8-bit integer weights.
+ *
+ * The weights of every layer are quantized symmetrically to int8 with one
+ * scale per output neuron, the inputs of the layer to unsigned integers in
+ * [0, kMaxDotU8] with one scale per layer. Dot products are accumulated in
+ * int32 by the dot_u8s8 SIMD kernel and rescaled before the bias and the
+ * activation. The activation scales default to the range of the sigmoid and
+ * are refined by Calibrate on a sample of images; unbounded ReLU outputs
+ * need the calibration. Outputs of tanh layers are shifted by one before
+ * the quantization, the shift is subtracted from the dot products through
+ * the sums of the weights. The double weights are kept, so the model is
+ * saved and loaded like the other ones.
+ */
+class QuantizedMlp : public AbstractMlp {
+ public:
+  explicit QuantizedMlp(const Topology &);
+
+  void SetInputLayer(const Vector &) override;
+  void ForwardPropagation() override;
+  void BackPropagation(const Vector &, double) override;
+  Vector GetOutput() const override;
+  LayerViews GetLayerViews() const override;
+  void SetMlp(const Tensor &, const Tensor &) override;
+  // Inference only: the optimizer is never used.
+  void SetOptimizer(const Optimizer &) override {}
+
+  void Calibrate(const Dataset &);
+  // Largest shifted input value of every layer, mapped to kMaxDotU8.
+  const Vector &GetRanges() const { return ranges_; }
+
+ private:
+  using Bytes = std::vector<std::uint8_t, AlignedAllocator<std::uint8_t>>;
+  using Weights = std::vector<std::int8_t, AlignedAllocator<std::int8_t>>;
+
+  // Weights of a layer transposed to one padded row per output neuron.
+  struct Layer {
+    std::size_t inputs;
+    std::size_t outputs;
+    std::size_t stride;
+    Weights weights;
+    Vector weight_scales;
+    std::vector<std::int32_t> weight_sums;
+    double input_scale;
+    double input_offset;
+  };
+
+  void Quantize();
+  double InputOffset(std::size_t layer) const;
+  void ResetRanges();
+
+  Tensor weights_;
+  Tensor biases_;
+  std::vector<Activation> activations_;
+  // Largest shifted input value of every layer, mapped to kMaxDotU8.
+  Vector ranges_;
+  std::vector<Layer> layers_;
+  Vector values_;
+  Vector output_;
+  Bytes input_;
+};
+
+}  // namespace s21
+
+#endif  // MLP_MODEL_QUANTIZED_MLP_QUANTIZED_MLP_H_
@@ -0,0 +1,18 @@
+#include "static_mlp.h"
+
+namespace s21 {
+
+template class StaticMlp<784, 100, 100, 26>;
+template class StaticMlp<784, 128, 256, 128, 26>;
+
+std::unique_ptr<AbstractMlp> MakeStaticMlp(const Topology &topology) {
+  if (DefaultStaticMlp::Matches(topology)) {
+    return std::make_unique<DefaultStaticMlp>(topology);
+  }
+  if (WideStaticMlp::Matches(topology)) {
+    return std::make_unique<WideStaticMlp>(topology);
+  }
+  throw std::invalid_argument("No static model for this topology");
+}
+
+}  // namespace s21
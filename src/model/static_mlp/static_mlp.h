@@ -0,0 +1,332 @@
+#ifndef MLP_MODEL_STATIC_MLP_STATIC_MLP_H_
+#define MLP_MODEL_STATIC_MLP_STATIC_MLP_H_
+
+#include <array>
+#include <tuple>
+#include <utility>
+
+#include "abstract_mlp.h"
+#include "config.h"
+#include "matrix_operations.h"
+#include "static_kernels.h"
+
+namespace s21 {
+
+/**
+ * @class StaticMlp
+ * @brief Multi-Layer Perceptron whose layer sizes are template arguments.
+ *
+ * Every layer is a set of aligned std::array members sized at compile time,
+ * so the propagations need no allocation and no dimension check. The layers
+ * whose shape is listed in StaticLayerShapes run kernels compiled with
+ * constant sizes in every instruction set unit, selected once when the model
+ * is created; the forward pass keeps blocks of columns in registers across
+ * all the inputs. Other shapes call the axpy and dot kernels of the SIMD
+ * table row by row. The weights are laid out like the ones of the matrix
+ * model, one row per input, and the model trains on one sample at a time
+ * with the same update order. The arrays make the object large: create it
+ * on the heap. Only the shapes instantiated in static_mlp.cc are available
+ * through MakeStaticMlp.
+ */
+template <std::size_t... Sizes>
+class StaticMlp : public AbstractMlp {
+  static_assert(sizeof...(Sizes) >= 2, "A model needs at least two layers");
+
+ public:
+  static constexpr std::array<std::size_t, sizeof...(Sizes)> kSizes{Sizes...};
+  static constexpr std::size_t kLayers = sizeof...(Sizes) - 1;
+  static constexpr std::size_t kInputs = kSizes.front();
+  static constexpr std::size_t kOutputs = kSizes.back();
+
+  explicit StaticMlp(const Topology &);
+
+  static bool Matches(const Topology &);
+
+  void SetInputLayer(const Vector &) override;
+  void ForwardPropagation() override;
+  void BackPropagation(const Vector &, double) override;
+  Vector GetOutput() const override;
+  void CopyOutput(Vector &) const override;
+  LayerViews GetLayerViews() const override;
+  void SetMlp(const Tensor &, const Tensor &) override;
+
+ private:
+  template <std::size_t In, std::size_t Out>
+  struct Layer {
+    static constexpr std::size_t kIn = In;
+    static constexpr std::size_t kOut = Out;
+
+    alignas(kMatrixAlignment) std::array<double, In * Out> weights;
+    alignas(kMatrixAlignment) std::array<double, Out> biases;
+    alignas(kMatrixAlignment) std::array<double, Out> values;
+    alignas(kMatrixAlignment) std::array<double, Out> errors;
+    Activation activation;
+    StaticLayerKernels kernels;
+  };
+
+  template <std::size_t In, std::size_t Out>
+  static StaticLayerKernels SelectKernels();
+  template <std::size_t In, std::size_t Out>
+  static void ForwardRows(const double *, const double *, const double *,
+                          double *);
+  template <std::size_t In, std::size_t Out>
+  static void BackwardRows(const double *, const double *, double *);
+  template <std::size_t In, std::size_t Out>
+  static void UpdateRows(const double *, const double *, double, double *,
+                         double *);
+
+  template <std::size_t I>
+  using LayerAt = Layer<kSizes[I], kSizes[I + 1]>;
+
+  template <std::size_t... I>
+  static std::tuple<LayerAt<I>...> MakeLayers(std::index_sequence<I...>);
+
+  using Layers = decltype(MakeLayers(std::make_index_sequence<kLayers>{}));
+
+  template <typename F, std::size_t... I>
+  void ForEachLayer(F &&func, std::index_sequence<I...>) {
+    (func(std::integral_constant<std::size_t, I>{}), ...);
+  }
+  template <typename F>
+  void ForEachLayer(F &&func) {
+    ForEachLayer(func, std::make_index_sequence<kLayers>{});
+  }
+
+  // Values feeding layer I: the input for the first one.
+  template <std::size_t I>
+  const double *InputOf() const {
+    if constexpr (I == 0) {
+      return input_.data();
+    } else {
+      return std::get<I - 1>(layers_).values.data();
+    }
+  }
+
+  alignas(kMatrixAlignment) std::array<double, kInputs> input_;
+  Layers layers_;
+};
+
+/**
+ * Fills the weights and the biases with random values and takes the
+ * activations of the topology.
+ *
+ * @throws std::invalid_argument If the topology has other layer sizes.
+ */
+template <std::size_t... Sizes>
+StaticMlp<Sizes...>::StaticMlp(const Topology &topology) : input_{} {
+  if (!Matches(topology)) {
+    throw std::invalid_argument("Topology does not match the static model");
+  }
+  ForEachLayer([&](auto index) {
+    auto &layer = std::get<index>(layers_);
+    std::generate(layer.weights.begin(), layer.weights.end(), RandomWeight);
+    std::generate(layer.biases.begin(), layer.biases.end(), RandomWeight);
+    layer.values.fill(0.0);
+    layer.errors.fill(0.0);
+    layer.activation = topology.GetActivation(index + 1);
+    using L = std::decay_t<decltype(layer)>;
+    layer.kernels = SelectKernels<L::kIn, L::kOut>();
+  });
+}
+
+/**
+ * Returns the kernels of a layer shape: the ones compiled with constant
+ * sizes for the instruction set in use when the shape is one of
+ * StaticLayerShapes, otherwise the row by row kernels below.
+ */
+template <std::size_t... Sizes>
+template <std::size_t In, std::size_t Out>
+StaticLayerKernels StaticMlp<Sizes...>::SelectKernels() {
+  constexpr std::size_t index = StaticShapeIndex<In, Out>();
+  if constexpr (index < kStaticLayerShapes) {
+    return GetStaticKernels()[index];
+  } else {
+    return {ForwardRows<In, Out>, BackwardRows<In, Out>, UpdateRows<In, Out>};
+  }
+}
+
+template <std::size_t... Sizes>
+template <std::size_t In, std::size_t Out>
+void StaticMlp<Sizes...>::ForwardRows(const double *input,
+                                      const double *weights,
+                                      const double *biases, double *values) {
+  const SimdKernels &kernels = GetSimdKernels();
+  std::copy(biases, biases + Out, values);
+  for (std::size_t i = 0; i < In; ++i) {
+    kernels.axpy(input[i], weights + i * Out, values, Out);
+  }
+}
+
+template <std::size_t... Sizes>
+template <std::size_t In, std::size_t Out>
+void StaticMlp<Sizes...>::BackwardRows(const double *weights,
+                                       const double *errors, double *sums) {
+  const SimdKernels &kernels = GetSimdKernels();
+  for (std::size_t i = 0; i < In; ++i) {
+    sums[i] = kernels.dot(weights + i * Out, errors, Out);
+  }
+}
+
+template <std::size_t... Sizes>
+template <std::size_t In, std::size_t Out>
+void StaticMlp<Sizes...>::UpdateRows(const double *input,
+                                     const double *errors, double lr,
+                                     double *weights, double *biases) {
+  const SimdKernels &kernels = GetSimdKernels();
+  for (std::size_t i = 0; i < In; ++i) {
+    const double x = -lr * input[i];
+    if (x == 0.0) continue;
+    kernels.axpy(x, errors, weights + i * Out, Out);
+  }
+  for (std::size_t j = 0; j < Out; ++j) {
+    biases[j] -= lr * errors[j];
+  }
+}
+
+template <std::size_t... Sizes>
+bool StaticMlp<Sizes...>::Matches(const Topology &topology) {
+  if (topology.GetLayersCount() != kSizes.size()) return false;
+  for (std::size_t i = 0; i < kSizes.size(); ++i) {
+    if (topology.GetLayerSize(i) != kSizes[i]) return false;
+  }
+  return true;
+}
+
+template <std::size_t... Sizes>
+void StaticMlp<Sizes...>::SetInputLayer(const Vector &input) {
+  if (input.size() != kInputs) {
+    throw std::invalid_argument("Input size doesn't match input layer size");
+  }
+  std::copy(input.begin(), input.end(), input_.begin());
+}
+
+/**
+ * Computes every layer as a sum of the weight rows scaled by the inputs with
+ * the forward kernel of its shape, then activates it with the SIMD kernel of
+ * its activation.
+ */
+template <std::size_t... Sizes>
+void StaticMlp<Sizes...>::ForwardPropagation() {
+  const SimdKernels &kernels = GetSimdKernels();
+  ForEachLayer([&](auto index) {
+    auto &layer = std::get<index>(layers_);
+    using L = std::decay_t<decltype(layer)>;
+    double *values = layer.values.data();
+    layer.kernels.forward(InputOf<index>(), layer.weights.data(),
+                          layer.biases.data(), values);
+    ActivationKernel(layer.activation, kernels, math_mode_)(values, values,
+                                                            L::kOut);
+  });
+}
+
+/**
+ * Propagates the deltas from the output layer down through the weights of
+ * the forward pass, then updates every layer, like the matrix model.
+ *
+ * @param expected The expected output.
+ * @param lr The learning rate.
+ */
+template <std::size_t... Sizes>
+void StaticMlp<Sizes...>::BackPropagation(const Vector &expected, double lr) {
+  if (expected.size() != kOutputs) {
+    throw std::invalid_argument(
+        "Expected output size doesn't match layer size");
+  }
+  auto &output = std::get<kLayers - 1>(layers_);
+  VisitActivation(output.activation, [&](auto policy) {
+    for (std::size_t j = 0; j < kOutputs; ++j) {
+      output.errors[j] = (output.values[j] - expected[j]) *
+                         policy.Derivative(output.values[j]);
+    }
+  });
+
+  ForEachLayer([&](auto step) {
+    constexpr std::size_t kIndex = kLayers - 1 - step;
+    if constexpr (kIndex > 0) {
+      auto &layer = std::get<kIndex>(layers_);
+      using L = std::decay_t<decltype(layer)>;
+      auto &prev = std::get<kIndex - 1>(layers_);
+      layer.kernels.backward(layer.weights.data(), layer.errors.data(),
+                             prev.errors.data());
+      VisitActivation(prev.activation, [&](auto policy) {
+        for (std::size_t i = 0; i < L::kIn; ++i) {
+          prev.errors[i] *= policy.Derivative(prev.values[i]);
+        }
+      });
+    }
+  });
+
+  ForEachLayer([&](auto index) {
+    auto &layer = std::get<index>(layers_);
+    layer.kernels.update(InputOf<index>(), layer.errors.data(), lr,
+                         layer.weights.data(), layer.biases.data());
+  });
+}
+
+template <std::size_t... Sizes>
+Vector StaticMlp<Sizes...>::GetOutput() const {
+  const auto &values = std::get<kLayers - 1>(layers_).values;
+  return Vector(values.begin(), values.end());
+}
+
+template <std::size_t... Sizes>
+void StaticMlp<Sizes...>::CopyOutput(Vector &output) const {
+  const auto &values = std::get<kLayers - 1>(layers_).values;
+  output.assign(values.begin(), values.end());
+}
+
+template <std::size_t... Sizes>
+LayerViews StaticMlp<Sizes...>::GetLayerViews() const {
+  std::vector<LayerView> layers;
+  std::apply(
+      [&](const auto &...layer) {
+        (layers.push_back(
+             {{layer.weights.data(), layer.kIn, layer.kOut, layer.kOut},
+              {layer.biases.data(), 1, layer.kOut, layer.kOut}}),
+         ...);
+      },
+      layers_);
+  return layers;
+}
+
+/**
+ * Copies weights of the same shape, e.g. read by MLP::Load.
+ *
+ * @throws std::invalid_argument If a layer has other dimensions.
+ */
+template <std::size_t... Sizes>
+void StaticMlp<Sizes...>::SetMlp(const Tensor &weights, const Tensor &biases) {
+  if (weights.size() != kLayers or biases.size() != kLayers) {
+    throw std::invalid_argument("Weights do not match the static model");
+  }
+  ForEachLayer([&](auto index) {
+    auto &layer = std::get<index>(layers_);
+    using L = std::decay_t<decltype(layer)>;
+    const Matrix &w = weights[index];
+    const Matrix &b = biases[index];
+    if (w.GetRows() != L::kIn or w.GetCols() != L::kOut or
+        b.GetSize() != L::kOut) {
+      throw std::invalid_argument("Weights do not match the static model");
+    }
+    std::copy(w.begin(), w.end(), layer.weights.begin());
+    std::copy(b.begin(), b.end(), layer.biases.begin());
+  });
+}
+
+// The shapes compiled into the library.
+using DefaultStaticMlp = StaticMlp<784, 100, 100, 26>;
+using WideStaticMlp = StaticMlp<784, 128, 256, 128, 26>;
+
+extern template class StaticMlp<784, 100, 100, 26>;
+extern template class StaticMlp<784, 128, 256, 128, 26>;
+
+/**
+ * Creates the static model of a topology.
+ *
+ * @throws std::invalid_argument If no static model has its layer sizes.
+ */
+std::unique_ptr<AbstractMlp> MakeStaticMlp(const Topology &);
+
+}  // namespace s21
+
+#endif  // MLP_MODEL_STATIC_MLP_STATIC_MLP_H_
@@ -3,6 +3,9 @@
 
 #include <cmath>
 #include <functional>
+#include <optional>
+
+#include "simd.h"
 
 namespace s21 {
 
@@ -14,22 +17,156 @@ constexpr double sigmoid(double x) { return 1.0 / (1.0 + std::exp(-x)); }
 constexpr double tanh(double x) { return std::tanh(x); }
 constexpr double relu(double x) { return (x > 0.0) ? x : 0.0; }
 
-// Activation function derivatives
-constexpr double sigmoid_derivative(double x) { return x * (1.0 - x); }
-constexpr double tanh_derivative(double x) {
-  return 1.0 - std::tanh(x) * std::tanh(x);
+// Activation function derivatives, expressed through the activated value
+// y = f(x), which is what the models keep after the forward pass.
+constexpr double sigmoid_derivative(double y) { return y * (1.0 - y); }
+constexpr double tanh_derivative(double y) { return 1.0 - y * y; }
+constexpr double relu_derivative(double y) { return (y > 0.0) ? 1.0 : 0.0; }
+
+/**
+ * @enum Activation
+ * @brief Activation of a layer, selected per layer in the Topology.
+ */
+enum class Activation { kSigmoid, kTanh, kRelu };
+
+/**
+ * @struct Sigmoid
+ * @brief Activation policy: the scalar function, its derivative and the
+ * matching kernels of the SIMD dispatch table. Code templated on a policy is
+ * instantiated once per activation and inlines the function. The math mode
+ * of the model selects the kernel of the sigmoid.
+ */
+struct Sigmoid {
+  static constexpr Activation kType = Activation::kSigmoid;
+
+  template <typename T>
+  static T Apply(T x) {
+    return T{1} / (T{1} + std::exp(-x));
+  }
+  template <typename T>
+  static T Derivative(T y) {
+    return y * (T{1} - y);
+  }
+  template <typename T>
+  static auto Kernel(const BasicSimdKernels<T> &kernels, MathMode mode) {
+    return mode == MathMode::kFast ? kernels.fast_sigmoid : kernels.sigmoid;
+  }
+  template <typename T>
+  static auto DerivativeKernel(const BasicSimdKernels<T> &kernels) {
+    return kernels.sigmoid_derivative;
+  }
+};
+
+struct Tanh {
+  static constexpr Activation kType = Activation::kTanh;
+
+  template <typename T>
+  static T Apply(T x) {
+    return std::tanh(x);
+  }
+  template <typename T>
+  static T Derivative(T y) {
+    return T{1} - y * y;
+  }
+  template <typename T>
+  static auto Kernel(const BasicSimdKernels<T> &kernels, MathMode) {
+    return kernels.tanh;
+  }
+  template <typename T>
+  static auto DerivativeKernel(const BasicSimdKernels<T> &kernels) {
+    return kernels.tanh_derivative;
+  }
+};
+
+struct Relu {
+  static constexpr Activation kType = Activation::kRelu;
+
+  template <typename T>
+  static T Apply(T x) {
+    return x > T{0} ? x : T{0};
+  }
+  template <typename T>
+  static T Derivative(T y) {
+    return y > T{0} ? T{1} : T{0};
+  }
+  template <typename T>
+  static auto Kernel(const BasicSimdKernels<T> &kernels, MathMode) {
+    return kernels.relu;
+  }
+  template <typename T>
+  static auto DerivativeKernel(const BasicSimdKernels<T> &kernels) {
+    return kernels.relu_derivative;
+  }
+};
+
+/**
+ * Calls a generic callable with the policy of an activation, so a switch
+ * over the activation is done once per layer instead of once per element.
+ */
+template <typename F>
+decltype(auto) VisitActivation(Activation activation, F &&func) {
+  switch (activation) {
+    case Activation::kTanh:
+      return func(Tanh{});
+    case Activation::kRelu:
+      return func(Relu{});
+    default:
+      return func(Sigmoid{});
+  }
+}
+
+template <typename T>
+typename BasicSimdKernels<T>::Unary ActivationKernel(
+    Activation activation, const BasicSimdKernels<T> &kernels,
+    MathMode mode = MathMode::kExact) {
+  return VisitActivation(
+      activation, [&](auto policy) { return policy.Kernel(kernels, mode); });
+}
+
+template <typename T>
+typename BasicSimdKernels<T>::Unary ActivationDerivativeKernel(
+    Activation activation, const BasicSimdKernels<T> &kernels) {
+  return VisitActivation(activation, [&](auto policy) {
+    return policy.DerivativeKernel(kernels);
+  });
+}
+
+// Activation of a known function pointer, empty for any other function.
+inline std::optional<Activation> FindActivation(activation_func func) {
+  if (func == sigmoid) return Activation::kSigmoid;
+  if (func == tanh) return Activation::kTanh;
+  if (func == relu) return Activation::kRelu;
+  return std::nullopt;
+}
+
+inline std::optional<Activation> FindActivationDerivative(
+    activation_derivative func) {
+  if (func == sigmoid_derivative) return Activation::kSigmoid;
+  if (func == tanh_derivative) return Activation::kTanh;
+  if (func == relu_derivative) return Activation::kRelu;
+  return std::nullopt;
 }
-constexpr double relu_derivative(double x) { return (x > 0.0) ? 1.0 : 0.0; }
 
 // Apply an activation function to a single value
 inline double ApplyActivation(double x, activation_func func) {
   return (*func)(x);
 }
 
+inline double ApplyActivation(double x, Activation activation) {
+  return VisitActivation(activation,
+                         [x](auto policy) { return policy.Apply(x); });
+}
+
 // Apply derivative of an activation function to a single value
 inline double ApplyActivationDerivative(double x, activation_derivative func) {
   return (*func)(x);
 }
+
+inline double ApplyActivationDerivative(double y, Activation activation) {
+  return VisitActivation(activation,
+                         [y](auto policy) { return policy.Derivative(y); });
+}
+
 }  // namespace s21
 
 #endif  // MLP_MODEL_UTILITY_ACTIVATION_FUNCTIONS_H_
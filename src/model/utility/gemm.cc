@@ -0,0 +1,359 @@
+#include "gemm.h"
+
+namespace s21 {
+
+namespace {
+
+template <typename T>
+using PackBuffer = std::vector<T, AlignedAllocator<T>>;
+
+/**
+ * @struct Epilogue
+ * @brief Work applied to finished elements of C before they are stored: a
+ * bias row broadcast over the rows of C followed by an activation kernel.
+ */
+template <typename T>
+struct Epilogue {
+  const T* bias;
+  typename BasicSimdKernels<T>::Unary activation;
+};
+
+/**
+ * Stores a computed tile into C as c = beta * c + alpha * tile. A zero beta
+ * overwrites C without reading it, so uninitialized values never propagate.
+ * With an epilogue the bias is added and the activation is applied to every
+ * row of the tile while it is still in L1, right before it is written out.
+ */
+template <typename T>
+inline void StoreTile(T* tile, std::size_t rows, std::size_t cols,
+                      std::size_t ld_tile, T* c, std::size_t rs_c,
+                      std::size_t cs_c, T alpha, T beta,
+                      const Epilogue<T>* epilogue) {
+  for (std::size_t i = 0; i < rows; ++i) {
+    T* row_tile = tile + i * ld_tile;
+    T* row_c = c + i * rs_c;
+    for (std::size_t j = 0; j < cols; ++j) {
+      T value = alpha * row_tile[j];
+      row_tile[j] = (beta == 0.0) ? value : beta * row_c[j * cs_c] + value;
+    }
+    if (epilogue) {
+      if (epilogue->bias) {
+        for (std::size_t j = 0; j < cols; ++j) {
+          row_tile[j] += epilogue->bias[j];
+        }
+      }
+      if (epilogue->activation) {
+        epilogue->activation(row_tile, row_tile, cols);
+      }
+    }
+    for (std::size_t j = 0; j < cols; ++j) {
+      row_c[j * cs_c] = row_tile[j];
+    }
+  }
+}
+
+/**
+ * Multiplies an MC x KC packed block of A by a KC x NC packed panel of B and
+ * accumulates the result into the matching block of C, one register tile at
+ * a time. Tiles are computed into a local buffer and then stored into C with
+ * its strides, which also covers the partial tiles at the edges.
+ */
+template <typename T>
+void MacroKernel(const BasicSimdKernels<T>& kernels, std::size_t mc,
+                 std::size_t nc, std::size_t kc, const T* packed_a,
+                 const T* packed_b, BasicMatrixView<T> c, T alpha, T beta,
+                 const Epilogue<T>* epilogue) {
+  const std::size_t kMr = kernels.gemm_mr, kNr = kernels.gemm_nr;
+  alignas(kMatrixAlignment) T tile[kMaxGemmMr * kMaxGemmNrOf<T>];
+  for (std::size_t jr = 0; jr < nc; jr += kNr) {
+    const std::size_t nr = std::min(kNr, nc - jr);
+    const T* b = packed_b + jr * kc;
+    for (std::size_t ir = 0; ir < mc; ir += kMr) {
+      const std::size_t mr = std::min(kMr, mc - ir);
+      kernels.gemm(kc, packed_a + ir * kc, b, tile);
+      if (epilogue) {
+        Epilogue<T> tile_epilogue{epilogue->bias, epilogue->activation};
+        if (tile_epilogue.bias) tile_epilogue.bias += jr;
+        StoreTile(tile, mr, nr, kNr, &c(ir, jr), c.GetRowStride(),
+                  c.GetColStride(), alpha, beta, &tile_epilogue);
+      } else {
+        StoreTile<T>(tile, mr, nr, kNr, &c(ir, jr), c.GetRowStride(),
+                     c.GetColStride(), alpha, beta, nullptr);
+      }
+    }
+  }
+}
+
+/**
+ * Computes C = alpha * A * B + beta * C for products with only a few rows in
+ * A. Packing B would cost as much as the multiplication itself, so B is
+ * streamed once per row of A: row by row when its rows are contiguous, or as
+ * dot products when its columns are contiguous (a transposed matrix).
+ * The epilogue, if any, is applied to each row of C once it is complete.
+ */
+template <typename T>
+void GemmSmall(const BasicSimdKernels<T>& kernels,
+               BasicMatrixView<const T> a, BasicMatrixView<const T> b,
+               BasicMatrixView<T> c, T alpha, T beta,
+               const Epilogue<T>* epilogue) {
+  const std::size_t inner = a.GetCols(), cols = b.GetCols();
+  const bool dot_rows = a.GetColStride() == 1 and b.GetRowStride() == 1;
+  const T* bias = epilogue ? epilogue->bias : nullptr;
+  const typename BasicSimdKernels<T>::Unary activation =
+      epilogue ? epilogue->activation : nullptr;
+  for (std::size_t i = 0; i < a.GetRows(); ++i) {
+    T* row_c = &c(i, 0);
+    const std::size_t cs_c = c.GetColStride();
+    if (b.GetColStride() == 1 and cs_c == 1) {
+      if (beta == 0.0) {
+        if (bias) {
+          std::copy(bias, bias + cols, row_c);
+        } else {
+          std::fill(row_c, row_c + cols, T{0});
+        }
+      } else {
+        if (beta != 1.0) kernels.scale(row_c, beta, row_c, cols);
+        if (bias) kernels.add(row_c, bias, row_c, cols);
+      }
+      for (std::size_t k = 0; k < inner; ++k) {
+        kernels.axpy(alpha * a(i, k), &b(k, 0), row_c, cols);
+      }
+      if (activation) activation(row_c, row_c, cols);
+    } else {
+      for (std::size_t j = 0; j < cols; ++j) {
+        T dot_product = 0.0;
+        if (dot_rows and inner > 0) {
+          dot_product = kernels.dot(&a(i, 0), &b(0, j), inner);
+        } else {
+          for (std::size_t k = 0; k < inner; ++k) {
+            dot_product += a(i, k) * b(k, j);
+          }
+        }
+        T& dst = row_c[j * cs_c];
+        dst = (beta == 0.0) ? alpha * dot_product
+                            : beta * dst + alpha * dot_product;
+        if (bias) dst += bias[j];
+        if (activation) activation(&dst, &dst, 1);
+      }
+    }
+  }
+}
+
+/**
+ * Blocked GEMM driver shared by Gemm() and GemmBiasActivate(). The epilogue
+ * is only applied during the last pass over the shared dimension, when the
+ * elements of C hold their final values.
+ */
+template <typename T>
+void GemmImpl(BasicMatrixView<const T> a, BasicMatrixView<const T> b,
+              BasicMatrixView<T> c, T alpha, T beta,
+              const Epilogue<T>* epilogue) {
+  if (a.GetCols() != b.GetRows() or c.GetRows() != a.GetRows() or
+      c.GetCols() != b.GetCols()) {
+    throw std::logic_error("Matrices have inconsistent dimensions");
+  }
+  const std::size_t m = a.GetRows(), n = b.GetCols(), k = a.GetCols();
+  if (m == 0 or n == 0) return;
+
+  const BasicSimdKernels<T>& kernels = GetSimdKernels<T>();
+  if (m < kGemmSmallRows or k == 0) {
+    GemmSmall(kernels, a, b, c, alpha, beta, epilogue);
+    return;
+  }
+
+  const std::size_t mr = kernels.gemm_mr, nr = kernels.gemm_nr;
+  thread_local PackBuffer<T> packed_a, packed_b;
+  packed_a.resize((m + mr - 1) / mr * mr * kGemmKc);
+  packed_b.resize(kGemmKc * (kGemmNc + kMaxGemmNrOf<T>));
+  // Thread local names refer to the buffers of the running thread, so the
+  // workers are given the buffers of the calling thread by pointer.
+  T* const pack_a = packed_a.data();
+  T* const pack_b = packed_b.data();
+
+  ThreadPool& pool = GetThreadPool();
+  const bool parallel = m * n * k >= kGemmParallelWork;
+  const auto run = [&pool, parallel](std::size_t count, auto&& body) {
+    if (parallel) {
+      pool.ParallelFor(count, body);
+    } else {
+      for (std::size_t i = 0; i < count; ++i) body(i);
+    }
+  };
+
+  for (std::size_t jc = 0; jc < n; jc += kGemmNc) {
+    const std::size_t nc = std::min(kGemmNc, n - jc);
+    const std::size_t col_tiles = (nc + kGemmNt - 1) / kGemmNt;
+    for (std::size_t pc = 0; pc < k; pc += kGemmKc) {
+      const std::size_t kc = std::min(kGemmKc, k - pc);
+      const T block_beta = (pc == 0) ? beta : T{1};
+      Epilogue<T> panel_epilogue{nullptr, nullptr};
+      const bool last = pc + kc == k and epilogue;
+      if (last) {
+        panel_epilogue = *epilogue;
+        if (panel_epilogue.bias) panel_epilogue.bias += jc;
+      }
+
+      // Both operands are packed in parallel: B by column tiles and A by
+      // blocks of MC rows, all of A for this KC slice at once.
+      run(col_tiles, [&](std::size_t tile) {
+        const std::size_t jt = tile * kGemmNt;
+        PackB(b.Block(pc, jc + jt, kc, std::min(kGemmNt, nc - jt)), nr,
+              pack_b + jt * kc);
+      });
+      const std::size_t row_blocks = (m + kGemmMc - 1) / kGemmMc;
+      run(row_blocks, [&](std::size_t block) {
+        const std::size_t ic = block * kGemmMc;
+        PackA(a.Block(ic, pc, std::min(kGemmMc, m - ic), kc), mr,
+              pack_a + ic * kc);
+      });
+
+      // C is split into MC x NT tiles that are scheduled dynamically; the
+      // tiles of one block of A are adjacent, so a thread usually reuses
+      // the block it has in L2.
+      run(row_blocks * col_tiles, [&](std::size_t tile) {
+        const std::size_t ic = tile / col_tiles * kGemmMc;
+        const std::size_t jt = tile % col_tiles * kGemmNt;
+        const std::size_t mc = std::min(kGemmMc, m - ic);
+        const std::size_t nt = std::min(kGemmNt, nc - jt);
+        Epilogue<T> tile_epilogue = panel_epilogue;
+        if (tile_epilogue.bias) tile_epilogue.bias += jt;
+        MacroKernel(kernels, mc, nt, kc, pack_a + ic * kc, pack_b + jt * kc,
+                    c.Block(ic, jc + jt, mc, nt), alpha, block_beta,
+                    last ? &tile_epilogue : nullptr);
+      });
+    }
+  }
+}
+
+template <typename T>
+void GemmBiasActivateImpl(BasicMatrixView<const T> a,
+                          BasicMatrixView<const T> b,
+                          BasicMatrixView<const T> bias, BasicMatrixView<T> c,
+                          typename BasicSimdKernels<T>::Unary activation) {
+  if (bias.GetRows() != 1 or bias.GetCols() != b.GetCols() or
+      bias.GetColStride() != 1) {
+    throw std::logic_error("Matrices have inconsistent dimensions");
+  }
+  Epilogue<T> epilogue{bias.Data(), activation};
+  GemmImpl<T>(a, b, c, T{1}, T{0}, &epilogue);
+}
+
+}  // namespace
+
+/**
+ * Computes C = alpha * A * B + beta * C using a cache-blocked algorithm.
+ *
+ * The product is split into KC x NC panels of B and MC x KC blocks of A that
+ * are packed into contiguous, zero-padded buffers, so the innermost loops read
+ * memory strictly sequentially. Each block is then multiplied by a register
+ * blocked micro-kernel that keeps an MR x NR tile of C in registers for the
+ * whole KC loop; the micro-kernel of the widest available instruction set is
+ * taken from the SIMD dispatch table. Large products are split into tiles of
+ * C that run on the shared thread pool. The operands may be arbitrary strided
+ * views, so transposed matrices and sub-blocks are multiplied without copying
+ * them first.
+ *
+ * @param a The left operand of size M x K.
+ * @param b The right operand of size K x N.
+ * @param c The output of size M x N, it must not alias a or b.
+ * @param alpha The scale of the product.
+ * @param beta The scale of the previous content of C, zero ignores it.
+ * @throws std::logic_error if the views have inconsistent dimensions.
+ */
+void Gemm(ConstMatrixView a, ConstMatrixView b, MatrixView c, double alpha,
+          double beta) {
+  GemmImpl<double>(a, b, c, alpha, beta, nullptr);
+}
+
+/**
+ * Single precision version of Gemm(), it uses the float kernels whose
+ * registers hold twice as many elements.
+ */
+void Gemm(ConstFloatMatrixView a, ConstFloatMatrixView b, FloatMatrixView c,
+          float alpha, float beta) {
+  GemmImpl<float>(a, b, c, alpha, beta, nullptr);
+}
+
+/**
+ * Computes C = activation(A * B + bias) in a single pass over C. The bias row
+ * is added to every row of the product and the activation kernel is applied
+ * to each register tile right after its last accumulation, so the product is
+ * never written to memory before it is activated.
+ *
+ * @param a The left operand of size M x K.
+ * @param b The right operand of size K x N.
+ * @param bias The bias row of size 1 x N.
+ * @param c The output of size M x N, it must not alias a or b.
+ * @param activation The activation kernel, nullptr applies none.
+ * @throws std::logic_error if the views have inconsistent dimensions.
+ */
+void GemmBiasActivate(ConstMatrixView a, ConstMatrixView b,
+                      ConstMatrixView bias, MatrixView c,
+                      SimdKernels::Unary activation) {
+  GemmBiasActivateImpl(a, b, bias, c, activation);
+}
+
+/**
+ * Single precision version of GemmBiasActivate().
+ */
+void GemmBiasActivate(ConstFloatMatrixView a, ConstFloatMatrixView b,
+                      ConstFloatMatrixView bias, FloatMatrixView c,
+                      BasicSimdKernels<float>::Unary activation) {
+  GemmBiasActivateImpl(a, b, bias, c, activation);
+}
+
+/**
+ * Packs a block of A into slivers of MR rows. Within a sliver the MR values of
+ * each column are stored next to each other, which is the order in which the
+ * micro-kernel consumes them. Missing rows of the last sliver are zero.
+ *
+ * @param a The MC x KC block of A to be packed.
+ * @param mr The number of rows in a sliver.
+ * @param packed The destination buffer of at least ceil(MC / MR) * MR * KC.
+ */
+template <typename T>
+void PackA(BasicMatrixView<const T> a, std::size_t mr, T* packed) {
+  const std::size_t rows = a.GetRows(), kc = a.GetCols();
+  for (std::size_t ir = 0; ir < rows; ir += mr) {
+    const std::size_t sliver = std::min(mr, rows - ir);
+    for (std::size_t k = 0; k < kc; ++k) {
+      for (std::size_t i = 0; i < sliver; ++i) packed[i] = a(ir + i, k);
+      for (std::size_t i = sliver; i < mr; ++i) packed[i] = T{0};
+      packed += mr;
+    }
+  }
+}
+
+/**
+ * Packs a panel of B into slivers of NR columns. Within a sliver the NR values
+ * of each row are stored next to each other. Missing columns of the last
+ * sliver are zero.
+ *
+ * @param b The KC x NC panel of B to be packed.
+ * @param nr The number of columns in a sliver.
+ * @param packed The destination buffer of at least KC * ceil(NC / NR) * NR.
+ */
+template <typename T>
+void PackB(BasicMatrixView<const T> b, std::size_t nr, T* packed) {
+  const std::size_t kc = b.GetRows(), cols = b.GetCols();
+  for (std::size_t jr = 0; jr < cols; jr += nr) {
+    const std::size_t sliver = std::min(nr, cols - jr);
+    for (std::size_t k = 0; k < kc; ++k) {
+      if (b.GetColStride() == 1) {
+        const T* row_b = &b(k, jr);
+        std::copy(row_b, row_b + sliver, packed);
+      } else {
+        for (std::size_t j = 0; j < sliver; ++j) packed[j] = b(k, jr + j);
+      }
+      std::fill(packed + sliver, packed + nr, T{0});
+      packed += nr;
+    }
+  }
+}
+
+template void PackA(BasicMatrixView<const double>, std::size_t, double*);
+template void PackA(BasicMatrixView<const float>, std::size_t, float*);
+template void PackB(BasicMatrixView<const double>, std::size_t, double*);
+template void PackB(BasicMatrixView<const float>, std::size_t, float*);
+
+}  // namespace s21
@@ -0,0 +1,50 @@
+#ifndef MLP_MODEL_UTILITY_GEMM_H_
+#define MLP_MODEL_UTILITY_GEMM_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "matrix.h"
+#include "simd.h"
+#include "thread_pool.h"
+
+namespace s21 {
+
+// Cache blocking: an MC x KC block of A stays in L2, a KC x NR sliver of B
+// stays in L1 and a KC x NC panel of B stays in L3. The register tile MR x NR
+// depends on the instruction set and comes from the SIMD dispatch table.
+constexpr std::size_t kGemmMc = 120;
+constexpr std::size_t kGemmKc = 256;
+constexpr std::size_t kGemmNc = 4096;
+
+// Products are computed in parallel over MC x NT tiles of C once they need at
+// least kGemmParallelWork multiply-adds. NT is a multiple of every NR.
+constexpr std::size_t kGemmNt = 256;
+constexpr std::size_t kGemmParallelWork = 64 * 64 * 64;
+
+// Products with fewer rows than this skip packing and stream B directly.
+constexpr std::size_t kGemmSmallRows = 4;
+
+void Gemm(ConstMatrixView a, ConstMatrixView b, MatrixView c,
+          double alpha = 1.0, double beta = 0.0);
+void Gemm(ConstFloatMatrixView a, ConstFloatMatrixView b, FloatMatrixView c,
+          float alpha = 1.0f, float beta = 0.0f);
+
+void GemmBiasActivate(ConstMatrixView a, ConstMatrixView b,
+                      ConstMatrixView bias, MatrixView c,
+                      SimdKernels::Unary activation);
+void GemmBiasActivate(ConstFloatMatrixView a, ConstFloatMatrixView b,
+                      ConstFloatMatrixView bias, FloatMatrixView c,
+                      BasicSimdKernels<float>::Unary activation);
+
+// Instantiated for float and double.
+template <typename T>
+void PackA(BasicMatrixView<const T> a, std::size_t mr, T *packed);
+template <typename T>
+void PackB(BasicMatrixView<const T> b, std::size_t nr, T *packed);
+
+}  // namespace s21
+
+#endif  // MLP_MODEL_UTILITY_GEMM_H_
@@ -10,7 +10,9 @@
 
 namespace s21 {
 
-using Dataset = std::vector<Image>;
+template <typename T>
+using BasicDataset = std::vector<BasicImage<T>>;
+using Dataset = BasicDataset<double>;
 constexpr std::size_t kStringWidth = 40u;
 enum class Color { kRed, kGreen, kBlue, kYellow, kGrey, kCyan, kMagenta, kEnd };
 
@@ -0,0 +1,224 @@
+#ifndef MLP_MODEL_UTILITY_MATRIX_H_
+#define MLP_MODEL_UTILITY_MATRIX_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace s21 {
+
+// Cache line size, used as the alignment of every matrix buffer.
+constexpr std::size_t kMatrixAlignment = 64;
+
+/**
+ * @class AlignedAllocator
+ * @brief Minimal allocator returning memory aligned to the given boundary.
+ *
+ * Used as the allocator of the matrix storage so that the first element of
+ * every matrix starts on a cache line, which is what SIMD loads expect.
+ */
+template <typename T, std::size_t Alignment = kMatrixAlignment>
+class AlignedAllocator {
+ public:
+  using value_type = T;
+
+  template <typename U>
+  struct rebind {
+    using other = AlignedAllocator<U, Alignment>;
+  };
+
+  AlignedAllocator() noexcept = default;
+  template <typename U>
+  explicit AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+  T* allocate(std::size_t n) {
+    return static_cast<T*>(
+        ::operator new(n * sizeof(T), std::align_val_t{Alignment}));
+  }
+
+  void deallocate(T* ptr, std::size_t) noexcept {
+    ::operator delete(ptr, std::align_val_t{Alignment});
+  }
+
+  template <typename U>
+  bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept {
+    return false;
+  }
+};
+
+/**
+ * @class BasicMatrixView
+ * @brief Non-owning strided view over a block of matrix elements.
+ *
+ * A view is a pointer plus shape and strides (in elements), so sub-blocks and
+ * transposed matrices can be described without copying any data. Element
+ * (i, j) is located at data[i * row_stride + j * col_stride].
+ */
+template <typename T>
+class BasicMatrixView {
+ public:
+  BasicMatrixView() = default;
+  BasicMatrixView(T* data, std::size_t rows, std::size_t cols,
+                  std::size_t row_stride, std::size_t col_stride = 1)
+      : data_{data},
+        rows_{rows},
+        cols_{cols},
+        row_stride_{row_stride},
+        col_stride_{col_stride} {}
+
+  template <typename U, typename = std::enable_if_t<
+                            std::is_same_v<const U, T> and
+                            !std::is_same_v<U, T>>>
+  BasicMatrixView(const BasicMatrixView<U>& other)  // NOLINT
+      : BasicMatrixView(other.Data(), other.GetRows(), other.GetCols(),
+                        other.GetRowStride(), other.GetColStride()) {}
+
+  T* Data() const { return data_; }
+  std::size_t GetRows() const { return rows_; }
+  std::size_t GetCols() const { return cols_; }
+  std::size_t GetRowStride() const { return row_stride_; }
+  std::size_t GetColStride() const { return col_stride_; }
+  bool IsEmpty() const { return rows_ == 0 or cols_ == 0; }
+  bool IsContiguous() const {
+    return col_stride_ == 1 and (row_stride_ == cols_ or rows_ <= 1);
+  }
+
+  T& operator()(std::size_t i, std::size_t j) const {
+    return data_[i * row_stride_ + j * col_stride_];
+  }
+
+  BasicMatrixView Transposed() const {
+    return {data_, cols_, rows_, col_stride_, row_stride_};
+  }
+
+  BasicMatrixView Block(std::size_t row, std::size_t col, std::size_t rows,
+                        std::size_t cols) const {
+    return {data_ + row * row_stride_ + col * col_stride_, rows, cols,
+            row_stride_, col_stride_};
+  }
+
+ private:
+  T* data_ = nullptr;
+  std::size_t rows_ = 0;
+  std::size_t cols_ = 0;
+  std::size_t row_stride_ = 0;
+  std::size_t col_stride_ = 1;
+};
+
+/**
+ * @class BasicMatrix
+ * @brief Dense row-major matrix stored in a single aligned buffer.
+ *
+ * All elements live in one contiguous, cache line aligned allocation with a
+ * row stride equal to the number of columns, so a whole matrix can be walked
+ * as a flat array and rows can be addressed with a single multiply.
+ */
+template <typename T>
+class BasicMatrix {
+ public:
+  using value_type = T;
+  using View = BasicMatrixView<T>;
+  using ConstView = BasicMatrixView<const T>;
+  using Storage = std::vector<T, AlignedAllocator<T>>;
+
+  BasicMatrix() : rows_{0}, cols_{0} {}
+  BasicMatrix(std::size_t rows, std::size_t cols, T value = T{})
+      : rows_{rows}, cols_{cols}, data_(rows * cols, value) {}
+  BasicMatrix(std::initializer_list<std::initializer_list<T>> rows)
+      : rows_{rows.size()}, cols_{rows.size() ? rows.begin()->size() : 0} {
+    data_.reserve(rows_ * cols_);
+    for (const auto& row : rows) {
+      if (row.size() != cols_) {
+        throw std::invalid_argument("Matrix rows have different sizes");
+      }
+      data_.insert(data_.end(), row.begin(), row.end());
+    }
+  }
+  explicit BasicMatrix(ConstView view)
+      : rows_{view.GetRows()}, cols_{view.GetCols()}, data_(rows_ * cols_) {
+    for (std::size_t i = 0; i < rows_; ++i) {
+      for (std::size_t j = 0; j < cols_; ++j) {
+        data_[i * cols_ + j] = view(i, j);
+      }
+    }
+  }
+  // Converts the elements of a matrix of another scalar type.
+  template <typename U, typename = std::enable_if_t<!std::is_same_v<U, T>>>
+  explicit BasicMatrix(const BasicMatrix<U>& other)
+      : rows_{other.GetRows()},
+        cols_{other.GetCols()},
+        data_(other.begin(), other.end()) {}
+  // Evaluates a lazy expression, see matrix_expression.h.
+  template <typename E, typename = typename E::ExpressionTag>
+  BasicMatrix(const E& expression) : BasicMatrix() {  // NOLINT
+    expression.EvaluateTo(*this);
+  }
+  template <typename E, typename = typename E::ExpressionTag>
+  BasicMatrix& operator=(const E& expression) {
+    expression.EvaluateTo(*this);
+    return *this;
+  }
+
+  std::size_t GetRows() const { return rows_; }
+  std::size_t GetCols() const { return cols_; }
+  std::size_t GetSize() const { return data_.size(); }
+  bool IsEmpty() const { return rows_ == 0 or cols_ == 0; }
+
+  T* Data() { return data_.data(); }
+  const T* Data() const { return data_.data(); }
+  T* begin() { return data_.data(); }
+  T* end() { return data_.data() + data_.size(); }
+  const T* begin() const { return data_.data(); }
+  const T* end() const { return data_.data() + data_.size(); }
+
+  T* operator[](std::size_t row) { return data_.data() + row * cols_; }
+  const T* operator[](std::size_t row) const {
+    return data_.data() + row * cols_;
+  }
+  T& operator()(std::size_t i, std::size_t j) { return data_[i * cols_ + j]; }
+  const T& operator()(std::size_t i, std::size_t j) const {
+    return data_[i * cols_ + j];
+  }
+
+  View GetView() { return {data_.data(), rows_, cols_, cols_}; }
+  ConstView GetView() const { return {data_.data(), rows_, cols_, cols_}; }
+  operator View() { return GetView(); }             // NOLINT
+  operator ConstView() const { return GetView(); }  // NOLINT
+
+  /**
+   * Changes the shape of the matrix. Existing elements are not preserved in
+   * any meaningful order; the buffer is only reallocated when it grows.
+   */
+  void Resize(std::size_t rows, std::size_t cols) {
+    rows_ = rows;
+    cols_ = cols;
+    data_.resize(rows * cols);
+  }
+
+  void Fill(T value) { std::fill(data_.begin(), data_.end(), value); }
+
+ private:
+  std::size_t rows_;
+  std::size_t cols_;
+  Storage data_;
+};
+
+using Vector = std::vector<double>;
+using Matrix = BasicMatrix<double>;
+using MatrixView = BasicMatrixView<double>;
+using ConstMatrixView = BasicMatrixView<const double>;
+using FloatMatrix = BasicMatrix<float>;
+using FloatMatrixView = BasicMatrixView<float>;
+using ConstFloatMatrixView = BasicMatrixView<const float>;
+
+}  // namespace s21
+
+#endif  // MLP_MODEL_UTILITY_MATRIX_H_
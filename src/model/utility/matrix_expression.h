@@ -0,0 +1,515 @@
+#ifndef MLP_MODEL_UTILITY_MATRIX_EXPRESSION_H_
+#define MLP_MODEL_UTILITY_MATRIX_EXPRESSION_H_
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "gemm.h"
+#include "matrix.h"
+
+// Lazy matrix expressions. The arithmetic operators on matrices build a tree
+// of small nodes instead of computing temporaries, and the tree is evaluated
+// only when it is assigned to a Matrix: element-wise nodes in a single fused
+// loop, products with the blocked Gemm(). A product at the root of an
+// assignment is written straight into the destination, with the scale and
+// the accumulation of += and -= folded into the alpha and beta of Gemm().
+//
+// Dimensions are checked when a node is built. Nodes refer to their matrix
+// operands, so an expression must be assigned within the full expression that
+// builds it and must not be stored with auto.
+
+namespace s21 {
+
+/**
+ * @struct MatrixExpression
+ * @brief CRTP base of the expression nodes.
+ *
+ * Every node provides its Scalar type, GetRows(), GetCols(), At(i, j) and
+ * Prepare(), which
+ * evaluates the products of the subtree into their own storage. Nodes with
+ * kFlat also provide Flat(k), the element at index k in row-major order, and
+ * nodes with kHasView provide View(), a strided view of their elements.
+ * Reads(p) tells whether the node reads the matrix stored at p, Aliases(p)
+ * whether it reads it at a position other than the one being written by an
+ * element-wise loop.
+ */
+template <typename E>
+struct MatrixExpression {
+  using ExpressionTag = void;
+
+  const E &Self() const { return static_cast<const E &>(*this); }
+  template <typename T>
+  void EvaluateTo(BasicMatrix<T> &) const;
+};
+
+template <typename T, typename = void>
+struct IsExpression : std::false_type {};
+
+template <typename T>
+struct IsExpression<T, std::void_t<typename T::ExpressionTag>>
+    : std::true_type {};
+
+template <typename T>
+struct IsMatrix : std::false_type {};
+
+template <typename T>
+struct IsMatrix<BasicMatrix<T>> : std::true_type {};
+
+template <typename T>
+constexpr bool kIsOperand = IsMatrix<T>::value or IsExpression<T>::value;
+
+template <typename T>
+using EnableIfOperand = std::enable_if_t<kIsOperand<T>>;
+
+template <typename L, typename R>
+using EnableIfOperands = std::enable_if_t<kIsOperand<L> and kIsOperand<R>>;
+
+inline void CheckExpressionSize(std::size_t rows, std::size_t cols) {
+  if (rows == 0 or cols == 0) {
+    throw std::logic_error("Matrix have inconsistent dimensions");
+  }
+}
+
+/**
+ * @class MatrixRef
+ * @brief Leaf of an expression, refers to a matrix without copying it.
+ */
+template <typename T>
+class MatrixRef : public MatrixExpression<MatrixRef<T>> {
+ public:
+  using Scalar = T;
+  static constexpr bool kFlat = true;
+  static constexpr bool kHasView = true;
+
+  explicit MatrixRef(const BasicMatrix<T> &matrix) : matrix_(&matrix) {}
+
+  std::size_t GetRows() const { return matrix_->GetRows(); }
+  std::size_t GetCols() const { return matrix_->GetCols(); }
+  T At(std::size_t i, std::size_t j) const { return (*matrix_)(i, j); }
+  T Flat(std::size_t k) const { return matrix_->Data()[k]; }
+  BasicMatrixView<const T> View() const { return matrix_->GetView(); }
+  bool Reads(const T *p) const { return matrix_->Data() == p; }
+  bool Aliases(const T *) const { return false; }
+  void Prepare() const {}
+
+ private:
+  const BasicMatrix<T> *matrix_;
+};
+
+// Matrices enter expressions as MatrixRef, nodes are stored by value.
+template <typename E>
+struct ExpressionOperand {
+  using Type = E;
+};
+
+template <typename T>
+struct ExpressionOperand<BasicMatrix<T>> {
+  using Type = MatrixRef<T>;
+};
+
+template <typename E>
+using OperandOf = typename ExpressionOperand<E>::Type;
+
+template <typename T>
+MatrixRef<T> MakeOperand(const BasicMatrix<T> &matrix) {
+  return MatrixRef<T>(matrix);
+}
+
+template <typename E>
+const E &MakeOperand(const MatrixExpression<E> &expression) {
+  return expression.Self();
+}
+
+/**
+ * @class ElementWiseExpression
+ * @brief Applies a binary operation to two expressions of the same size.
+ */
+template <typename L, typename R, typename Op>
+class ElementWiseExpression
+    : public MatrixExpression<ElementWiseExpression<L, R, Op>> {
+ public:
+  using Scalar = typename L::Scalar;
+  static_assert(std::is_same_v<Scalar, typename R::Scalar>,
+                "Operands have different scalar types");
+  static constexpr bool kFlat = L::kFlat and R::kFlat;
+  static constexpr bool kHasView = false;
+
+  ElementWiseExpression(L left, R right)
+      : left_(std::move(left)), right_(std::move(right)) {
+    CheckExpressionSize(left_.GetRows(), left_.GetCols());
+    if (left_.GetRows() != right_.GetRows() or
+        left_.GetCols() != right_.GetCols()) {
+      throw std::logic_error("Matrices have inconsistent dimensions");
+    }
+  }
+
+  std::size_t GetRows() const { return left_.GetRows(); }
+  std::size_t GetCols() const { return left_.GetCols(); }
+  Scalar At(std::size_t i, std::size_t j) const {
+    return Op{}(left_.At(i, j), right_.At(i, j));
+  }
+  Scalar Flat(std::size_t k) const {
+    return Op{}(left_.Flat(k), right_.Flat(k));
+  }
+  bool Reads(const Scalar *p) const {
+    return left_.Reads(p) or right_.Reads(p);
+  }
+  bool Aliases(const Scalar *p) const {
+    return left_.Aliases(p) or right_.Aliases(p);
+  }
+  void Prepare() const {
+    left_.Prepare();
+    right_.Prepare();
+  }
+  const L &GetLeft() const { return left_; }
+  const R &GetRight() const { return right_; }
+
+ private:
+  L left_;
+  R right_;
+};
+
+/**
+ * @class ScaleExpression
+ * @brief Multiplies each element of an expression by a number.
+ */
+template <typename E>
+class ScaleExpression : public MatrixExpression<ScaleExpression<E>> {
+ public:
+  using Scalar = typename E::Scalar;
+  static constexpr bool kFlat = E::kFlat;
+  static constexpr bool kHasView = false;
+
+  ScaleExpression(E expression, Scalar factor)
+      : expression_(std::move(expression)), factor_(factor) {
+    CheckExpressionSize(expression_.GetRows(), expression_.GetCols());
+  }
+
+  std::size_t GetRows() const { return expression_.GetRows(); }
+  std::size_t GetCols() const { return expression_.GetCols(); }
+  Scalar At(std::size_t i, std::size_t j) const {
+    return expression_.At(i, j) * factor_;
+  }
+  Scalar Flat(std::size_t k) const { return expression_.Flat(k) * factor_; }
+  bool Reads(const Scalar *p) const { return expression_.Reads(p); }
+  bool Aliases(const Scalar *p) const { return expression_.Aliases(p); }
+  void Prepare() const { expression_.Prepare(); }
+
+ private:
+  E expression_;
+  Scalar factor_;
+};
+
+/**
+ * @class TransposeExpression
+ * @brief Transpose of an expression. The transpose of a matrix is a strided
+ * view of it, so it is passed to Gemm() without being copied.
+ */
+template <typename E>
+class TransposeExpression : public MatrixExpression<TransposeExpression<E>> {
+ public:
+  using Scalar = typename E::Scalar;
+  static constexpr bool kFlat = false;
+  static constexpr bool kHasView = E::kHasView;
+
+  explicit TransposeExpression(E expression)
+      : expression_(std::move(expression)) {
+    CheckExpressionSize(expression_.GetRows(), expression_.GetCols());
+  }
+
+  std::size_t GetRows() const { return expression_.GetCols(); }
+  std::size_t GetCols() const { return expression_.GetRows(); }
+  Scalar At(std::size_t i, std::size_t j) const {
+    return expression_.At(j, i);
+  }
+  BasicMatrixView<const Scalar> View() const {
+    return expression_.View().Transposed();
+  }
+  bool Reads(const Scalar *p) const { return expression_.Reads(p); }
+  bool Aliases(const Scalar *p) const { return expression_.Reads(p); }
+  void Prepare() const { expression_.Prepare(); }
+
+ private:
+  E expression_;
+};
+
+/**
+ * @class ProductOperand
+ * @brief Operand of a product. Operands that are views of matrices are used
+ * in place, any other expression is evaluated into a temporary first.
+ */
+template <typename E>
+class ProductOperand {
+ public:
+  using Scalar = typename E::Scalar;
+
+  explicit ProductOperand(E expression) : expression_(std::move(expression)) {}
+
+  std::size_t GetRows() const { return expression_.GetRows(); }
+  std::size_t GetCols() const { return expression_.GetCols(); }
+  bool Reads(const Scalar *p) const { return expression_.Reads(p); }
+  void Prepare() const {
+    if constexpr (not E::kHasView) {
+      if (value_.IsEmpty()) value_ = expression_;
+    }
+  }
+  BasicMatrixView<const Scalar> View() const {
+    if constexpr (E::kHasView) {
+      return expression_.View();
+    } else {
+      return value_.GetView();
+    }
+  }
+
+ private:
+  E expression_;
+  mutable BasicMatrix<Scalar> value_;
+};
+
+/**
+ * @class ProductExpression
+ * @brief Scaled matrix product, alpha * left * right.
+ */
+template <typename L, typename R>
+class ProductExpression : public MatrixExpression<ProductExpression<L, R>> {
+ public:
+  using Scalar = typename L::Scalar;
+  static_assert(std::is_same_v<Scalar, typename R::Scalar>,
+                "Operands have different scalar types");
+  static constexpr bool kFlat = true;
+  static constexpr bool kHasView = false;
+
+  ProductExpression(L left, R right, Scalar alpha = 1)
+      : left_(std::move(left)), right_(std::move(right)), alpha_(alpha) {
+    CheckExpressionSize(left_.GetRows(), left_.GetCols());
+    CheckExpressionSize(right_.GetRows(), right_.GetCols());
+    if (left_.GetCols() != right_.GetRows()) {
+      throw std::logic_error("Matrices have inconsistent dimensions");
+    }
+  }
+
+  std::size_t GetRows() const { return left_.GetRows(); }
+  std::size_t GetCols() const { return right_.GetCols(); }
+  Scalar At(std::size_t i, std::size_t j) const { return value_(i, j); }
+  Scalar Flat(std::size_t k) const { return value_.Data()[k]; }
+  bool Reads(const Scalar *p) const {
+    return left_.Reads(p) or right_.Reads(p);
+  }
+  // The product is evaluated into its own storage before any element of the
+  // destination is written.
+  bool Aliases(const Scalar *) const { return false; }
+  void Prepare() const {
+    if (not value_.IsEmpty()) return;
+    PrepareOperands();
+    value_.Resize(GetRows(), GetCols());
+    EvaluateInto(value_, 1, 0);
+  }
+  void PrepareOperands() const {
+    left_.Prepare();
+    right_.Prepare();
+  }
+  // dst = scale * alpha * left * right + beta * dst
+  void EvaluateInto(BasicMatrixView<Scalar> dst, Scalar scale,
+                    Scalar beta) const {
+    Gemm(left_.View(), right_.View(), dst, scale * alpha_, beta);
+  }
+  ProductExpression Scaled(Scalar factor) const {
+    return ProductExpression(left_, right_, alpha_ * factor);
+  }
+
+ private:
+  ProductExpression(ProductOperand<L> left, ProductOperand<R> right,
+                    Scalar alpha)
+      : left_(std::move(left)), right_(std::move(right)), alpha_(alpha) {}
+
+  ProductOperand<L> left_;
+  ProductOperand<R> right_;
+  Scalar alpha_;
+  mutable BasicMatrix<Scalar> value_;
+};
+
+template <typename T, typename E, typename F>
+void ForEachElement(BasicMatrix<T> &dst, const E &expression, F func) {
+  if constexpr (E::kFlat) {
+    T *data = dst.Data();
+    for (std::size_t k = 0; k < dst.GetSize(); ++k) {
+      func(data[k], expression.Flat(k));
+    }
+  } else {
+    for (std::size_t i = 0; i < dst.GetRows(); ++i) {
+      for (std::size_t j = 0; j < dst.GetCols(); ++j) {
+        func(dst(i, j), expression.At(i, j));
+      }
+    }
+  }
+}
+
+/**
+ * Evaluates an expression into a matrix with one fused element-wise loop.
+ * When the loop would overwrite elements that are still to be read, the
+ * expression is evaluated into a new matrix that then replaces dst.
+ */
+template <typename T, typename E>
+void AssignElementWise(BasicMatrix<T> &dst, const E &expression) {
+  expression.Prepare();
+  const auto assign = [](T &d, T x) { d = x; };
+  if (expression.Aliases(dst.Data())) {
+    BasicMatrix<T> value(expression.GetRows(), expression.GetCols());
+    ForEachElement(value, expression, assign);
+    dst = std::move(value);
+    return;
+  }
+  dst.Resize(expression.GetRows(), expression.GetCols());
+  ForEachElement(dst, expression, assign);
+}
+
+template <typename T, typename E>
+void AssignTo(BasicMatrix<T> &dst, const E &expression) {
+  AssignElementWise(dst, expression);
+}
+
+// dst = alpha * a * b is computed by Gemm() directly into dst.
+template <typename T, typename L, typename R>
+void AssignTo(BasicMatrix<T> &dst,
+              const ProductExpression<L, R> &expression) {
+  if (expression.Reads(dst.Data())) {
+    AssignElementWise(dst, expression);
+    return;
+  }
+  expression.PrepareOperands();
+  dst.Resize(expression.GetRows(), expression.GetCols());
+  expression.EvaluateInto(dst, 1, 0);
+}
+
+// dst = op(a * b, e): the product is computed into dst, then combined with e
+// in place.
+template <typename T, typename L, typename R, typename E, typename Op>
+void AssignTo(
+    BasicMatrix<T> &dst,
+    const ElementWiseExpression<ProductExpression<L, R>, E, Op> &expression) {
+  if (expression.Reads(dst.Data())) {
+    AssignElementWise(dst, expression);
+    return;
+  }
+  const ProductExpression<L, R> &product = expression.GetLeft();
+  product.PrepareOperands();
+  expression.GetRight().Prepare();
+  dst.Resize(expression.GetRows(), expression.GetCols());
+  product.EvaluateInto(dst, 1, 0);
+  ForEachElement(dst, expression.GetRight(),
+                 [](T &d, T x) { d = Op{}(d, x); });
+}
+
+/**
+ * Adds sign * expression to dst with one fused element-wise loop.
+ *
+ * @throws std::logic_error if the sizes of dst and the expression differ.
+ */
+template <typename T, typename E>
+void AccumulateElementWise(BasicMatrix<T> &dst, const E &expression,
+                           T sign) {
+  if (dst.GetRows() != expression.GetRows() or
+      dst.GetCols() != expression.GetCols()) {
+    throw std::logic_error("Matrices have inconsistent dimensions");
+  }
+  expression.Prepare();
+  if (expression.Aliases(dst.Data())) {
+    BasicMatrix<T> value;
+    AssignElementWise(value, expression);
+    AccumulateElementWise(dst, MatrixRef<T>(value), sign);
+    return;
+  }
+  ForEachElement(dst, expression, [sign](T &d, T x) { d += sign * x; });
+}
+
+template <typename T, typename E>
+void AccumulateTo(BasicMatrix<T> &dst, const E &expression, T sign) {
+  AccumulateElementWise(dst, expression, sign);
+}
+
+// dst += sign * alpha * a * b is a single Gemm() call with beta = 1.
+template <typename T, typename L, typename R>
+void AccumulateTo(BasicMatrix<T> &dst,
+                  const ProductExpression<L, R> &expression, T sign) {
+  if (expression.Reads(dst.Data())) {
+    AccumulateElementWise(dst, expression, sign);
+    return;
+  }
+  expression.PrepareOperands();
+  expression.EvaluateInto(dst, sign, 1);
+}
+
+template <typename E>
+template <typename T>
+void MatrixExpression<E>::EvaluateTo(BasicMatrix<T> &dst) const {
+  AssignTo(dst, Self());
+}
+
+template <typename L, typename R, typename = EnableIfOperands<L, R>>
+auto operator+(const L &left, const R &right) {
+  return ElementWiseExpression<OperandOf<L>, OperandOf<R>, std::plus<>>(
+      MakeOperand(left), MakeOperand(right));
+}
+
+template <typename L, typename R, typename = EnableIfOperands<L, R>>
+auto operator-(const L &left, const R &right) {
+  return ElementWiseExpression<OperandOf<L>, OperandOf<R>, std::minus<>>(
+      MakeOperand(left), MakeOperand(right));
+}
+
+template <typename L, typename R, typename = EnableIfOperands<L, R>>
+auto operator*(const L &left, const R &right) {
+  return ProductExpression<OperandOf<L>, OperandOf<R>>(MakeOperand(left),
+                                                       MakeOperand(right));
+}
+
+template <typename E, typename = EnableIfOperand<E>>
+auto operator*(const E &expression, double d) {
+  using Scalar = typename OperandOf<E>::Scalar;
+  return ScaleExpression<OperandOf<E>>(MakeOperand(expression),
+                                       static_cast<Scalar>(d));
+}
+
+template <typename L, typename R>
+ProductExpression<L, R> operator*(const ProductExpression<L, R> &product,
+                                  double d) {
+  return product.Scaled(static_cast<typename L::Scalar>(d));
+}
+
+template <typename T, typename E, typename = EnableIfOperand<E>>
+void operator+=(BasicMatrix<T> &dst, const E &expression) {
+  AccumulateTo(dst, MakeOperand(expression), T{1});
+}
+
+template <typename T, typename E,
+          typename = std::enable_if_t<IsExpression<E>::value>>
+void operator-=(BasicMatrix<T> &dst, const E &expression) {
+  AccumulateTo(dst, expression, T{-1});
+}
+
+/**
+ * Transposes a matrix or an expression lazily.
+ *
+ * @throws std::logic_error if the matrix is empty.
+ */
+template <typename E, typename = EnableIfOperand<E>>
+auto Transpose(const E &expression) {
+  return TransposeExpression<OperandOf<E>>(MakeOperand(expression));
+}
+
+// Lazy Hadamard product, used when at least one operand is an expression.
+template <typename L, typename R, typename = EnableIfOperands<L, R>,
+          typename = std::enable_if_t<IsExpression<L>::value or
+                                      IsExpression<R>::value>>
+auto MultiplyHadamard(const L &left, const R &right) {
+  return ElementWiseExpression<OperandOf<L>, OperandOf<R>,
+                               std::multiplies<>>(MakeOperand(left),
+                                                  MakeOperand(right));
+}
+
+}  // namespace s21
+
+#endif  // MLP_MODEL_UTILITY_MATRIX_EXPRESSION_H_
@@ -12,21 +12,37 @@ namespace s21 {
  * @return A new matrix that contains the result of the operation.
  * @throws std::logic_error if the input matrices have inconsistent dimensions.
  */
-template <typename Op>
-Matrix BinaryOp(const Matrix& m1, const Matrix& m2, Op op) {
-  if (m1.empty() or m2.empty() or m1.size() != m2.size() or
-      m1[0].size() != m2[0].size()) {
+template <typename Op, typename T>
+BasicMatrix<T> BinaryOp(const BasicMatrix<T>& m1, const MatrixOf<T>& m2,
+                        Op op) {
+  if (m1.IsEmpty() or m2.IsEmpty() or m1.GetRows() != m2.GetRows() or
+      m1.GetCols() != m2.GetCols()) {
     throw std::logic_error("Matrices have inconsistent dimensions");
   }
-  Matrix result_matrix(m1.size(), Vector(m1[0].size()));
-  // #pragma omp parallel for
-  for (std::size_t i = 0; i < m1.size(); ++i) {
-    const Vector &row_m1 = m1[i], &row_m2 = m2[i];
-    Vector& row_result = result_matrix[i];
-    for (std::size_t j = 0; j < row_m1.size(); ++j) {
-      row_result[j] = op(row_m1[j], row_m2[j]);
-    }
+  BasicMatrix<T> result_matrix(m1.GetRows(), m1.GetCols());
+  std::transform(m1.begin(), m1.end(), m2.begin(), result_matrix.begin(), op);
+
+  return result_matrix;
+}
+
+/**
+ * Applies a vectorized binary kernel to two matrices of the same size.
+ *
+ * @param m1 The first matrix.
+ * @param m2 The second matrix.
+ * @param kernel The element-wise kernel from the SIMD dispatch table.
+ * @return A new matrix that contains the result of the operation.
+ * @throws std::logic_error if the input matrices have inconsistent dimensions.
+ */
+template <typename T>
+BasicMatrix<T> BinaryOp(const BasicMatrix<T>& m1, const MatrixOf<T>& m2,
+                        void (*kernel)(const T*, const T*, T*, std::size_t)) {
+  if (m1.IsEmpty() or m2.IsEmpty() or m1.GetRows() != m2.GetRows() or
+      m1.GetCols() != m2.GetCols()) {
+    throw std::logic_error("Matrices have inconsistent dimensions");
   }
+  BasicMatrix<T> result_matrix(m1.GetRows(), m1.GetCols());
+  kernel(m1.Data(), m2.Data(), result_matrix.Data(), m1.GetSize());
 
   return result_matrix;
 }
@@ -38,9 +54,9 @@ Matrix BinaryOp(const Matrix& m1, const Matrix& m2, Op op) {
  * @param m2 The second input matrix to be added.
  * @return A new matrix representing the sum of m1 and m2.
  */
-Matrix Addition(const Matrix& m1, const Matrix& m2) {
-  auto add = [](double a, double b) { return a + b; };
-  return BinaryOp(m1, m2, add);
+template <typename T>
+BasicMatrix<T> Addition(const BasicMatrix<T>& m1, const MatrixOf<T>& m2) {
+  return BinaryOp(m1, m2, GetSimdKernels<T>().add);
 }
 
 /**
@@ -50,9 +66,9 @@ Matrix Addition(const Matrix& m1, const Matrix& m2) {
  * @param m2 The second input matrix.
  * @return  A new matrix after performing the subtraction operation.
  */
-Matrix Subtraction(const Matrix& m1, const Matrix& m2) {
-  auto sub = [](double a, double b) { return a - b; };
-  return BinaryOp(m1, m2, sub);
+template <typename T>
+BasicMatrix<T> Subtraction(const BasicMatrix<T>& m1, const MatrixOf<T>& m2) {
+  return BinaryOp(m1, m2, GetSimdKernels<T>().sub);
 }
 
 /**
@@ -63,34 +79,27 @@ Matrix Subtraction(const Matrix& m1, const Matrix& m2) {
  * @return  A new matrix after performing the element-wise multiplication
  * operation.
  */
-Matrix MultiplyHadamard(const Matrix& m1, const Matrix& m2) {
-  auto mul = [](double a, double b) { return a * b; };
-  return BinaryOp(m1, m2, mul);
+template <typename T>
+BasicMatrix<T> MultiplyHadamard(const BasicMatrix<T>& m1,
+                                const MatrixOf<T>& m2) {
+  return BinaryOp(m1, m2, GetSimdKernels<T>().mul);
 }
 
 /**
- * Multiplies two matrices using the standard matrix multiplication algorithm.
+ * Multiplies two matrices using the cache-blocked GEMM algorithm.
  *
  * @param m1 The first input matrix to be multiplied.
  * @param m2 The second input matrix to be multiplied.
  * @return A new matrix after performing the matrix multiplication operation.
  * @throws std::logic_error if matrices have inconsistent dimensions.
  */
-Matrix Multiplication(const Matrix& m1, const Matrix& m2) {
-  if (m1.empty() or m2.empty() or m1[0].size() != m2.size()) {
+template <typename T>
+BasicMatrix<T> Multiplication(const BasicMatrix<T>& m1, const MatrixOf<T>& m2) {
+  if (m1.IsEmpty() or m2.IsEmpty() or m1.GetCols() != m2.GetRows()) {
     throw std::logic_error("Matrices have inconsistent dimensions");
   }
-  const std::size_t rows_m1 = m1.size(), cols_m2 = m2[0].size();
-  Matrix result_matrix(rows_m1, Vector(cols_m2));
-  // #pragma omp parallel for
-  for (std::size_t i = 0; i < rows_m1; ++i) {
-    for (std::size_t j = 0; j < cols_m2; ++j) {
-      result_matrix[i][j] = 0.0;
-      for (std::size_t k = 0; k < m1[0].size(); ++k) {
-        result_matrix[i][j] += m1[i][k] * m2[k][j];
-      }
-    }
-  }
+  BasicMatrix<T> result_matrix(m1.GetRows(), m2.GetCols());
+  Gemm(m1, m2, result_matrix);
 
   return result_matrix;
 }
@@ -103,67 +112,93 @@ Matrix Multiplication(const Matrix& m1, const Matrix& m2) {
  * @return A new matrix after performing the scalar multiplication operation.
  * @throws std::logic_error if the matrix is empty.
  */
-Matrix MultiplyNumber(const Matrix& matrix, const double d) {
-  if (matrix.empty() or matrix[0].empty()) {
+template <typename T>
+BasicMatrix<T> MultiplyNumber(const BasicMatrix<T>& matrix, const double d) {
+  if (matrix.IsEmpty()) {
     throw std::logic_error("Matrix have inconsistent dimensions");
   }
-  Matrix result_matrix(matrix.size(), Vector(matrix[0].size()));
-  // #pragma omp parallel for
-  for (std::size_t i = 0; i < matrix.size(); ++i) {
-    std::transform(matrix[i].begin(), matrix[i].end(), result_matrix[i].begin(),
-                   [&](double x) { return x * d; });
-  }
+  BasicMatrix<T> result_matrix(matrix.GetRows(), matrix.GetCols());
+  GetSimdKernels<T>().scale(matrix.Data(), static_cast<T>(d),
+                            result_matrix.Data(), matrix.GetSize());
 
   return result_matrix;
 }
 
 /**
- * Transpose a matrix.
+ * Apply an activation function element-wise to a matrix. Known activation
+ * functions are evaluated by the vectorized kernels of the SIMD dispatch
+ * table, any other function is called for each element.
  *
- * @param matrix The input matrix to be transposed.
- * @return A new transposed matrix.
+ * @param matrix The input matrix to be activated.
+ * @param func The activation function to be applied.
+ * @return A new matrix with the activation function applied element-wise.
  * @throws std::logic_error if the matrix is empty.
  */
-Matrix Transpose(const Matrix& matrix) {
-  if (matrix.empty() or matrix[0].empty()) {
-    throw std::logic_error("Matrix have inconsistent dimensions");
-  }
-  const std::size_t rows = matrix[0].size(), cols = matrix.size();
-  Matrix result_matrix(rows, Vector(cols));
-  // #pragma omp parallel for
-  for (std::size_t i = 0; i < rows; ++i) {
-    for (std::size_t j = 0; j < cols; ++j) {
-      result_matrix[i][j] = matrix[j][i];
-    }
-  }
+template <typename T>
+BasicMatrix<T> Activate(const BasicMatrix<T>& matrix, activation_func func) {
+  BasicMatrix<T> result_matrix;
+  ActivateInto(result_matrix, matrix, func);
+
+  return result_matrix;
+}
+
+template <typename T>
+BasicMatrix<T> Activate(const BasicMatrix<T>& matrix, Activation activation,
+                        MathMode mode) {
+  BasicMatrix<T> result_matrix;
+  ActivateInto(result_matrix, matrix, activation, mode);
 
   return result_matrix;
 }
 
 /**
- * Apply an activation function element-wise to a matrix.
+ * Computes the output of a fully connected layer, func(input * weights +
+ * biases), with a fused kernel: the bias and the activation are applied to
+ * each tile of the product as soon as it is computed, so the pre-activation
+ * values are never stored in a separate matrix.
  *
- * @param matrix The input matrix to be activated.
- * @param func The activation function to be applied.
- * @return A new matrix with the activation function applied element-wise.
- * @throws std::logic_error if the matrix is empty.
+ * @param input The input values of the layer, one sample per row.
+ * @param weights The weights of the layer.
+ * @param biases The bias row of the layer.
+ * @param func The activation function.
+ * @param result The output values, resized to match the product.
+ * @throws std::logic_error if the matrices have inconsistent dimensions.
  */
-Matrix Activate(const Matrix& matrix, activation_func func) {
-  if (matrix.empty() or matrix[0].empty()) {
-    throw std::logic_error("Matrix have inconsistent dimensions");
+template <typename T>
+void ActivateLayer(const BasicMatrix<T>& input, const MatrixOf<T>& weights,
+                   const MatrixOf<T>& biases, activation_func func,
+                   BasicMatrix<T>& result) {
+  if (input.GetCols() != weights.GetRows()) {
+    throw std::logic_error("Matrices have inconsistent dimensions");
   }
-  Matrix result_matrix(matrix.size(), Vector(matrix[0].size()));
-  // #pragma omp parallel for
-  for (std::size_t i = 0; i < matrix.size(); ++i) {
-    std::transform(matrix[i].begin(), matrix[i].end(), result_matrix[i].begin(),
-                   [&](double x) { return ApplyActivation(x, func); });
+  if (const std::optional<Activation> activation = FindActivation(func)) {
+    ActivateLayer(input, weights, biases, *activation, result);
+    return;
   }
+  result.Resize(input.GetRows(), weights.GetCols());
+  GemmBiasActivate(input, weights, biases, result, nullptr);
+  std::transform(result.begin(), result.end(), result.begin(),
+                 [&](T x) { return T(ApplyActivation(x, func)); });
+}
 
-  return result_matrix;
+// The math mode of the model selects the kernel of the sigmoid.
+template <typename T>
+void ActivateLayer(const BasicMatrix<T>& input, const MatrixOf<T>& weights,
+                   const MatrixOf<T>& biases, Activation activation,
+                   BasicMatrix<T>& result, MathMode mode) {
+  if (input.GetCols() != weights.GetRows()) {
+    throw std::logic_error("Matrices have inconsistent dimensions");
+  }
+  result.Resize(input.GetRows(), weights.GetCols());
+  const BasicSimdKernels<T>& kernels = GetSimdKernels<T>();
+  GemmBiasActivate(input, weights, biases, result,
+                   ActivationKernel(activation, kernels, mode));
 }
 
 /**
  * Apply the derivative of an activation function element-wise to a matrix.
+ * Known derivatives are evaluated by the vectorized kernels of the SIMD
+ * dispatch table, any other function is called for each element.
  *
  * @param matrix The input matrix to be activated.
  * @param func The derivative of the activation function to be applied.
@@ -171,23 +206,27 @@ Matrix Activate(const Matrix& matrix, activation_func func) {
  * element-wise.
  * @throws std::logic_error if the matrix is empty.
  */
-Matrix ActivateDerivative(const Matrix& matrix, activation_derivative func) {
-  if (matrix.empty() or matrix[0].empty()) {
-    throw std::logic_error("Matrix have inconsistent dimensions");
-  }
-  Matrix result_matrix(matrix.size(), Vector(matrix[0].size()));
-  // #pragma omp parallel for
-  for (std::size_t i = 0; i < matrix.size(); ++i) {
-    std::transform(
-        matrix[i].begin(), matrix[i].end(), result_matrix[i].begin(),
-        [&](double x) { return ApplyActivationDerivative(x, func); });
-  }
+template <typename T>
+BasicMatrix<T> ActivateDerivative(const BasicMatrix<T>& matrix,
+                                  activation_derivative func) {
+  BasicMatrix<T> result_matrix;
+  ActivateDerivativeInto(result_matrix, matrix, func);
+
+  return result_matrix;
+}
+
+template <typename T>
+BasicMatrix<T> ActivateDerivative(const BasicMatrix<T>& matrix,
+                                  Activation activation) {
+  BasicMatrix<T> result_matrix;
+  ActivateDerivativeInto(result_matrix, matrix, activation);
 
   return result_matrix;
 }
 
 /**
- * Multiplies two matrices using the Winograd algorithm.
+ * Multiplies two matrices using the Winograd algorithm. The factors and the
+ * tiles of the result are computed on the shared thread pool.
  *
  * @param m1 The first input matrix to be multiplied.
  * @param m2 The second input matrix to be multiplied.
@@ -195,36 +234,29 @@ Matrix ActivateDerivative(const Matrix& matrix, activation_derivative func) {
  * algorithm.
  * @throws std::logic_error if matrices have inconsistent dimensions.
  */
-Matrix MultiplyWinograd(const Matrix& m1, const Matrix& m2) {
-  if (m1.empty() or m2.empty() or m1[0].size() != m2.size()) {
+template <typename T>
+BasicMatrix<T> MultiplyWinograd(const BasicMatrix<T>& m1,
+                                const MatrixOf<T>& m2) {
+  if (m1.IsEmpty() or m2.IsEmpty() or m1.GetCols() != m2.GetRows()) {
     throw std::logic_error("Matrices have inconsistent dimensions");
   }
 
-  const std::size_t rows_m1 = m1.size(), cols_m2 = m2[0].size();
-  Matrix result_matrix(rows_m1, Vector(cols_m2));
+  const std::size_t rows_m1 = m1.GetRows(), cols_m2 = m2.GetCols();
+  BasicMatrix<T> result_matrix(rows_m1, cols_m2);
 
-  Vector row_factors(rows_m1);
+  std::vector<T> row_factors(rows_m1);
   ComputeRowFactors(m1, row_factors);
 
-  Vector col_factors(cols_m2);
+  std::vector<T> col_factors(cols_m2);
   ComputeColFactors(m2, col_factors);
 
-  const std::size_t num_threads = std::thread::hardware_concurrency();
-  std::vector<std::thread> threads(num_threads);
-  std::size_t chunk_size = rows_m1 / num_threads;
-  std::size_t start_row = 0, end_row = chunk_size;
-  for (std::size_t t = 0; t < num_threads; ++t) {
-    if (t == num_threads - 1) end_row = rows_m1;
-    threads[t] = std::thread(ComputeResultMatrix, std::cref(m1), std::cref(m2),
-                             std::cref(row_factors), std::cref(col_factors),
-                             std::ref(result_matrix), start_row, end_row);
-    start_row += chunk_size;
-    end_row += chunk_size;
-  }
-
-  for (auto& thread : threads) {
-    thread.join();
-  }
+  GetThreadPool().ParallelFor2D(
+      rows_m1, cols_m2, kWinogradTile, kWinogradTile,
+      [&](std::size_t row_begin, std::size_t row_end, std::size_t col_begin,
+          std::size_t col_end) {
+        ComputeResultMatrix(m1, m2, row_factors, col_factors, result_matrix,
+                            row_begin, row_end, col_begin, col_end);
+      });
 
   return result_matrix;
 }
@@ -234,11 +266,9 @@ Matrix MultiplyWinograd(const Matrix& m1, const Matrix& m2) {
  *
  * @param matrix The matrix to be randomized.
  */
-void RandomizeMatrix(Matrix& matrix) {
-  // #pragma omp parallel for
-  for (Vector& vector : matrix) {
-    RandomizeVector(vector);
-  }
+template <typename T>
+void RandomizeMatrix(BasicMatrix<T>& matrix) {
+  std::generate(matrix.begin(), matrix.end(), RandomWeight);
 }
 
 /**
@@ -254,6 +284,15 @@ void RandomizeVector(Vector& vector) {
   }
 }
 
+namespace {
+
+std::mt19937_64 &WeightGenerator() {
+  static std::mt19937_64 gen(std::random_device{}());
+  return gen;
+}
+
+}  // namespace
+
 /**
  * Generates a random weight value.
  *
@@ -262,48 +301,68 @@ void RandomizeVector(Vector& vector) {
  * @return A randomly generated weight value.
  */
 double RandomWeight() {
-  static std::mt19937_64 gen(std::random_device{}());
   static std::uniform_real_distribution<double> dist(-0.5, 0.5);
-  return dist(gen);
+  return dist(WeightGenerator());
 }
 
 /**
- * Computes the row factors matrix for Winograd algorithm.
+ * Seeds the generator of the random weights, so the weights of the models
+ * created afterwards are reproducible.
+ *
+ * @param seed The seed of the generator.
+ */
+void SeedRandomWeights(unsigned seed) { WeightGenerator().seed(seed); }
+
+/**
+ * Computes the row factors matrix for Winograd algorithm. Blocks of rows are
+ * processed in parallel.
  *
  * @param m1 The first input matrix of the multiplication.
  * @param row_factors The vector of row factors.
  */
-void ComputeRowFactors(const Matrix& m1, Vector& row_factors) {
-  const std::size_t half = m1[0].size() / 2;
-  for (std::size_t i = 0; i < m1.size(); ++i) {
-    double factor = m1[i][0] * m1[i][1];
-    for (std::size_t j = 1; j < half; ++j) {
-      factor += m1[i][2 * j] * m1[i][2 * j + 1];
-    }
-    row_factors[i] = factor;
-  }
+template <typename T>
+void ComputeRowFactors(const BasicMatrix<T>& m1, std::vector<T>& row_factors) {
+  const std::size_t half = m1.GetCols() / 2;
+  GetThreadPool().ParallelForRange(
+      m1.GetRows(), kWinogradTile, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+          const T* row = m1[i];
+          T factor = 0;
+          for (std::size_t j = 0; j < half; ++j) {
+            factor += row[2 * j] * row[2 * j + 1];
+          }
+          row_factors[i] = factor;
+        }
+      });
 }
 
 /**
- * Computes the column factors matrix for Winograd algorithm.
+ * Computes the column factors matrix for Winograd algorithm. Blocks of
+ * columns are processed in parallel, each of them row by row, so the matrix
+ * is read along its rows.
  *
  * @param m2 The second input matrix of the multiplication.
  * @param col_factors The vector of column factors.
  */
-void ComputeColFactors(const Matrix& m2, Vector& col_factors) {
-  const std::size_t half = m2.size() / 2;
-  for (std::size_t i = 0; i < m2[0].size(); ++i) {
-    double factor = m2[0][i] * m2[1][i];
-    for (std::size_t j = 1; j < half; ++j) {
-      factor += m2[2 * j][i] * m2[2 * j + 1][i];
-    }
-    col_factors[i] = factor;
-  }
+template <typename T>
+void ComputeColFactors(const BasicMatrix<T>& m2, std::vector<T>& col_factors) {
+  const std::size_t half = m2.GetRows() / 2;
+  GetThreadPool().ParallelForRange(
+      m2.GetCols(), kWinogradTile, [&](std::size_t begin, std::size_t end) {
+        std::fill(col_factors.begin() + begin, col_factors.begin() + end, T{0});
+        for (std::size_t j = 0; j < half; ++j) {
+          const T* even = m2[2 * j];
+          const T* odd = m2[2 * j + 1];
+          for (std::size_t i = begin; i < end; ++i) {
+            col_factors[i] += even[i] * odd[i];
+          }
+        }
+      });
 }
 
 /**
- * Computes the result matrix by multiplying the two given matrices m1 and m2,
- * and subtracting the row and column factors.
+ * Computes a tile of the result matrix by multiplying the two given matrices
+ * m1 and m2, and subtracting the row and column factors.
  *
  * @param m1 The first input matrix to be multiplied.
  * @param m2 The second input matrix to be multiplied.
@@ -314,22 +373,27 @@ void ComputeColFactors(const Matrix& m2, Vector& col_factors) {
  * @param result_matrix The output matrix that will store the computed result.
  * @param start_row The starting row index (inclusive).
  * @param end_row The ending row index (exclusive).
+ * @param start_col The starting column index (inclusive).
+ * @param end_col The ending column index (exclusive).
  */
-void ComputeResultMatrix(const Matrix& m1, const Matrix& m2,
-                         const Vector& row_factors, const Vector& col_factors,
-                         Matrix& result_matrix, std::size_t start_row,
-                         std::size_t end_row) {
-  const std::size_t cols_m2 = m2[0].size();
-  const std::size_t half = m1[0].size() / 2;
+template <typename T>
+void ComputeResultMatrix(const BasicMatrix<T>& m1, const MatrixOf<T>& m2,
+                         const std::vector<T>& row_factors,
+                         const std::vector<T>& col_factors,
+                         BasicMatrix<T>& result_matrix, std::size_t start_row,
+                         std::size_t end_row, std::size_t start_col,
+                         std::size_t end_col) {
+  const std::size_t inner = m1.GetCols();
+  const std::size_t half = inner / 2;
   for (std::size_t i = start_row; i < end_row; ++i) {
-    for (std::size_t j = 0; j < cols_m2; ++j) {
-      double dot_product = -row_factors[i] - col_factors[j];
+    for (std::size_t j = start_col; j < end_col; ++j) {
+      T dot_product = -row_factors[i] - col_factors[j];
       for (std::size_t k = 0; k < half; ++k) {
         dot_product += (m1[i][2 * k] + m2[2 * k + 1][j]) *
                        (m1[i][2 * k + 1] + m2[2 * k][j]);
       }
-      if (m1[0].size() % 2 != 0) {
-        dot_product += m1[i][m1[0].size() - 1] * m2[m1[0].size() - 1][j];
+      if (inner % 2 != 0) {
+        dot_product += m1[i][inner - 1] * m2[inner - 1][j];
       }
       result_matrix[i][j] = dot_product;
     }
@@ -337,69 +401,357 @@ void ComputeResultMatrix(const Matrix& m1, const Matrix& m2,
 }
 
 /**
- * Multiplies two matrices m1 and m2 using either the standard multiplication
- * algorithm or the Winograd algorithm, depending on the size of the matrices.
+ * Multiplies two matrices m1 and m2 using the cache-blocked GEMM algorithm.
  *
  * @param m1 The first input matrix to be multiplied.
  * @param m2 The second input matrix to be multiplied.
  * @return A new matrix after performing the matrix multiplication operation.
  * @throws std::logic_error if matrices have inconsistent dimensions.
  */
-Matrix Multiply(const Matrix& m1, const Matrix& m2) {
-  if (m1.empty() or m2.empty() or m1[0].size() != m2.size()) {
+template <typename T>
+BasicMatrix<T> Multiply(const BasicMatrix<T>& m1, const MatrixOf<T>& m2) {
+  if (m1.IsEmpty() or m2.IsEmpty() or m1.GetCols() != m2.GetRows()) {
     throw std::logic_error("Matrices have inconsistent dimensions");
   }
 
-  if (m1.size() > kWinogradThreshold and m2[0].size() > kWinogradThreshold and
-      m1[0].size() > kWinogradThreshold) {
-    return MultiplyWinograd(m1, m2);
-  } else {
-    return Multiplication(m1, m2);
+  return Multiplication(m1, m2);
+}
+
+/**
+ * Multiplies the transpose of the first matrix by the second one, m1^T * m2.
+ * The transpose is read through a strided view, so it is never materialized.
+ *
+ * @param m1 The matrix to be transposed, of size K x M.
+ * @param m2 The second matrix, of size K x N.
+ * @return The resulting M x N matrix.
+ * @throws std::logic_error if the matrices have inconsistent dimensions.
+ */
+template <typename T>
+BasicMatrix<T> MultiplyTN(const BasicMatrix<T>& m1, const MatrixOf<T>& m2) {
+  if (m1.IsEmpty() or m2.IsEmpty() or m1.GetRows() != m2.GetRows()) {
+    throw std::logic_error("Matrices have inconsistent dimensions");
   }
+  BasicMatrix<T> result_matrix(m1.GetCols(), m2.GetCols());
+  Gemm(m1.GetView().Transposed(), m2, result_matrix);
+
+  return result_matrix;
 }
 
 /**
- * Overloaded operator+ that performs matrix addition.
+ * Multiplies the first matrix by the transpose of the second one, m1 * m2^T.
+ * Each element is a dot product of two contiguous rows, so the transpose is
+ * never materialized.
  *
- * @param m1 The first input matrix to be added.
- * @param m2 The second input matrix to be added.
- * @return A new matrix representing the sum of m1 and m2.
+ * @param m1 The first matrix, of size M x K.
+ * @param m2 The matrix to be transposed, of size N x K.
+ * @return The resulting M x N matrix.
+ * @throws std::logic_error if the matrices have inconsistent dimensions.
  */
-Matrix operator+(const Matrix& m1, const Matrix& m2) {
-  return Addition(m1, m2);
+template <typename T>
+BasicMatrix<T> MultiplyNT(const BasicMatrix<T>& m1, const MatrixOf<T>& m2) {
+  if (m1.IsEmpty() or m2.IsEmpty() or m1.GetCols() != m2.GetCols()) {
+    throw std::logic_error("Matrices have inconsistent dimensions");
+  }
+  BasicMatrix<T> result_matrix(m1.GetRows(), m2.GetRows());
+  Gemm(m1, m2.GetView().Transposed(), result_matrix);
+
+  return result_matrix;
 }
 
+namespace {
+
 /**
- * Overloaded operator- that performs matrix subtraction.
+ * Checks that two matrices are non-empty and have the same dimensions.
  *
- * @param m1 The first input matrix to be subtracted.
- * @param m2 The second input matrix to be subtracted.
- * @return A new matrix after performing the subtraction operation.
+ * @throws std::logic_error if the matrices have inconsistent dimensions.
  */
-Matrix operator-(const Matrix& m1, const Matrix& m2) {
-  return Subtraction(m1, m2);
+template <typename T>
+void CheckSameSize(const BasicMatrix<T>& m1, const MatrixOf<T>& m2) {
+  if (m1.IsEmpty() or m2.IsEmpty() or m1.GetRows() != m2.GetRows() or
+      m1.GetCols() != m2.GetCols()) {
+    throw std::logic_error("Matrices have inconsistent dimensions");
+  }
 }
 
 /**
- * Overloaded operator* that performs matrix multiplication.
+ * Prepares the destination of a product of size rows x cols. A zero beta
+ * discards the previous content, so the destination is resized; otherwise it
+ * is accumulated into and must already have the right size.
  *
- * @param m1 The first input matrix to be multiplied.
- * @param m2 The second input matrix to be multiplied.
- * @return A new matrix after performing the matrix multiplication operation.
+ * @throws std::logic_error if the destination has inconsistent dimensions.
  */
-Matrix operator*(const Matrix& m1, const Matrix& m2) {
-  return Multiply(m1, m2);
+template <typename T>
+void PrepareProduct(BasicMatrix<T>& dst, std::size_t rows, std::size_t cols,
+                    double beta) {
+  if (beta == 0.0) {
+    dst.Resize(rows, cols);
+  } else if (dst.GetRows() != rows or dst.GetCols() != cols) {
+    throw std::logic_error("Matrices have inconsistent dimensions");
+  }
 }
 
+}  // namespace
+
 /**
- * Overloaded operator* that multiplies a matrix with a scalar value.
+ * Adds the second matrix to the first one in place, m1 += m2.
  *
- * @param matrix The input matrix to be multiplied.
- * @param d The scalar value with which the matrix is to be multiplied.
- * @return A new matrix after performing the scalar multiplication operation.
+ * @param m1 The matrix to be updated.
+ * @param m2 The matrix to be added.
+ * @throws std::logic_error if the matrices have inconsistent dimensions.
+ */
+template <typename T>
+void AddInPlace(BasicMatrix<T>& m1, const MatrixOf<T>& m2) {
+  CheckSameSize(m1, m2);
+  GetSimdKernels<T>().add(m1.Data(), m2.Data(), m1.Data(), m1.GetSize());
+}
+
+/**
+ * Subtracts the second matrix from the first one in place, m1 -= m2.
+ *
+ * @param m1 The matrix to be updated.
+ * @param m2 The matrix to be subtracted.
+ * @throws std::logic_error if the matrices have inconsistent dimensions.
+ */
+template <typename T>
+void SubInPlace(BasicMatrix<T>& m1, const MatrixOf<T>& m2) {
+  CheckSameSize(m1, m2);
+  GetSimdKernels<T>().sub(m1.Data(), m2.Data(), m1.Data(), m1.GetSize());
+}
+
+/**
+ * Multiplies the first matrix by the second one element-wise in place.
+ *
+ * @param m1 The matrix to be updated.
+ * @param m2 The matrix of factors.
+ * @throws std::logic_error if the matrices have inconsistent dimensions.
+ */
+template <typename T>
+void MultiplyHadamardInPlace(BasicMatrix<T>& m1, const MatrixOf<T>& m2) {
+  CheckSameSize(m1, m2);
+  GetSimdKernels<T>().mul(m1.Data(), m2.Data(), m1.Data(), m1.GetSize());
+}
+
+/**
+ * Multiplies each element of a matrix by a number in place.
+ *
+ * @param matrix The matrix to be updated.
+ * @param d The factor.
+ * @throws std::logic_error if the matrix is empty.
  */
-Matrix operator*(const Matrix& matrix, const double d) {
-  return MultiplyNumber(matrix, d);
+template <typename T>
+void MultiplyNumberInPlace(BasicMatrix<T>& matrix, double d) {
+  if (matrix.IsEmpty()) {
+    throw std::logic_error("Matrix have inconsistent dimensions");
+  }
+  GetSimdKernels<T>().scale(matrix.Data(), static_cast<T>(d), matrix.Data(),
+                            matrix.GetSize());
+}
+
+/**
+ * Adds a scaled matrix to another one in a single pass, y += a * x.
+ *
+ * @param y The matrix to be updated.
+ * @param a The scale of x.
+ * @param x The matrix to be added.
+ * @throws std::logic_error if the matrices have inconsistent dimensions.
+ */
+template <typename T>
+void AxpyInto(BasicMatrix<T>& y, double a, const MatrixOf<T>& x) {
+  CheckSameSize(y, x);
+  GetSimdKernels<T>().axpy(static_cast<T>(a), x.Data(), y.Data(), y.GetSize());
+}
+
+/**
+ * Subtracts two matrices into a destination, dst = m1 - m2. The destination
+ * is resized and reuses its storage when it is large enough.
+ *
+ * @param dst The result, it may alias m1 or m2.
+ * @param m1 The minuend.
+ * @param m2 The subtrahend.
+ * @throws std::logic_error if the matrices have inconsistent dimensions.
+ */
+template <typename T>
+void SubtractInto(BasicMatrix<T>& dst, const MatrixOf<T>& m1,
+                  const MatrixOf<T>& m2) {
+  CheckSameSize(m1, m2);
+  dst.Resize(m1.GetRows(), m1.GetCols());
+  GetSimdKernels<T>().sub(m1.Data(), m2.Data(), dst.Data(), m1.GetSize());
+}
+
+/**
+ * Computes dst = alpha * m1 * m2 + beta * dst without allocating memory once
+ * the destination has reached its size.
+ *
+ * @param dst The result, it must not alias m1 or m2.
+ * @param m1 The first matrix, of size M x K.
+ * @param m2 The second matrix, of size K x N.
+ * @param alpha The scale of the product.
+ * @param beta The scale of the previous content of dst, zero resizes dst.
+ * @throws std::logic_error if the matrices have inconsistent dimensions.
+ */
+template <typename T>
+void MultiplyInto(BasicMatrix<T>& dst, const MatrixOf<T>& m1,
+                  const MatrixOf<T>& m2, double alpha, double beta) {
+  if (m1.IsEmpty() or m2.IsEmpty() or m1.GetCols() != m2.GetRows()) {
+    throw std::logic_error("Matrices have inconsistent dimensions");
+  }
+  PrepareProduct(dst, m1.GetRows(), m2.GetCols(), beta);
+  Gemm(m1, m2, dst, static_cast<T>(alpha), static_cast<T>(beta));
+}
+
+/**
+ * Computes dst = alpha * m1^T * m2 + beta * dst, the in-place counterpart of
+ * MultiplyTN().
+ *
+ * @param dst The result, it must not alias m1 or m2.
+ * @param m1 The matrix to be transposed, of size K x M.
+ * @param m2 The second matrix, of size K x N.
+ * @param alpha The scale of the product.
+ * @param beta The scale of the previous content of dst, zero resizes dst.
+ * @throws std::logic_error if the matrices have inconsistent dimensions.
+ */
+template <typename T>
+void MultiplyTNInto(BasicMatrix<T>& dst, const MatrixOf<T>& m1,
+                    const MatrixOf<T>& m2, double alpha, double beta) {
+  if (m1.IsEmpty() or m2.IsEmpty() or m1.GetRows() != m2.GetRows()) {
+    throw std::logic_error("Matrices have inconsistent dimensions");
+  }
+  PrepareProduct(dst, m1.GetCols(), m2.GetCols(), beta);
+  Gemm(m1.GetView().Transposed(), m2, dst, static_cast<T>(alpha),
+       static_cast<T>(beta));
+}
+
+/**
+ * Computes dst = alpha * m1 * m2^T + beta * dst, the in-place counterpart of
+ * MultiplyNT().
+ *
+ * @param dst The result, it must not alias m1 or m2.
+ * @param m1 The first matrix, of size M x K.
+ * @param m2 The matrix to be transposed, of size N x K.
+ * @param alpha The scale of the product.
+ * @param beta The scale of the previous content of dst, zero resizes dst.
+ * @throws std::logic_error if the matrices have inconsistent dimensions.
+ */
+template <typename T>
+void MultiplyNTInto(BasicMatrix<T>& dst, const MatrixOf<T>& m1,
+                    const MatrixOf<T>& m2, double alpha, double beta) {
+  if (m1.IsEmpty() or m2.IsEmpty() or m1.GetCols() != m2.GetCols()) {
+    throw std::logic_error("Matrices have inconsistent dimensions");
+  }
+  PrepareProduct(dst, m1.GetRows(), m2.GetRows(), beta);
+  Gemm(m1, m2.GetView().Transposed(), dst, static_cast<T>(alpha),
+       static_cast<T>(beta));
+}
+
+/**
+ * Adds a scaled outer product to a matrix, dst += alpha * x^T * y, where x
+ * and y are rows. This is the weight update of a single sample: every row of
+ * dst takes one axpy with y in a single pass, the rows whose factor in x is
+ * zero are skipped and large matrices are updated in parallel by blocks of
+ * rows.
+ *
+ * @param dst The matrix to be updated, of size M x N.
+ * @param alpha The scale of the product.
+ * @param x The row of the M factors of the rows of dst.
+ * @param y The row of N values added to the rows of dst.
+ * @throws std::logic_error if the matrices have inconsistent dimensions.
+ */
+template <typename T>
+void GerInto(BasicMatrix<T>& dst, double alpha, const MatrixOf<T>& x,
+             const MatrixOf<T>& y) {
+  if (x.GetRows() != 1 or y.GetRows() != 1 or dst.GetRows() != x.GetCols() or
+      dst.GetCols() != y.GetCols()) {
+    throw std::logic_error("Matrices have inconsistent dimensions");
+  }
+  const BasicSimdKernels<T>& kernels = GetSimdKernels<T>();
+  const auto update = [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+      const T factor = static_cast<T>(alpha) * x(0, i);
+      if (factor != T{0}) {
+        kernels.axpy(factor, y.Data(), dst[i], dst.GetCols());
+      }
+    }
+  };
+  if (dst.GetSize() >= kGerParallelWork) {
+    GetThreadPool().ParallelForRange(dst.GetRows(), kGerRows, update);
+  } else {
+    update(0, dst.GetRows());
+  }
+}
+
+/**
+ * Applies an activation function to each element of a matrix into a
+ * destination of the same size.
+ *
+ * @param dst The result, it may alias the input matrix.
+ * @param matrix The input matrix.
+ * @param func The activation function.
+ * @throws std::logic_error if the matrix is empty.
+ */
+template <typename T>
+void ActivateInto(BasicMatrix<T>& dst, const MatrixOf<T>& matrix,
+                  activation_func func) {
+  if (matrix.IsEmpty()) {
+    throw std::logic_error("Matrix have inconsistent dimensions");
+  }
+  if (const std::optional<Activation> activation = FindActivation(func)) {
+    ActivateInto(dst, matrix, *activation);
+    return;
+  }
+  dst.Resize(matrix.GetRows(), matrix.GetCols());
+  std::transform(matrix.begin(), matrix.end(), dst.begin(),
+                 [&](T x) { return T(ApplyActivation(x, func)); });
+}
+
+// The activation selects the kernel of its policy once for the whole matrix,
+// in the math mode of the caller.
+template <typename T>
+void ActivateInto(BasicMatrix<T>& dst, const MatrixOf<T>& matrix,
+                  Activation activation, MathMode mode) {
+  if (matrix.IsEmpty()) {
+    throw std::logic_error("Matrix have inconsistent dimensions");
+  }
+  dst.Resize(matrix.GetRows(), matrix.GetCols());
+  const BasicSimdKernels<T>& kernels = GetSimdKernels<T>();
+  ActivationKernel(activation, kernels, mode)(matrix.Data(), dst.Data(),
+                                             matrix.GetSize());
+}
+
+/**
+ * Applies the derivative of an activation function to each element of a
+ * matrix into a destination of the same size.
+ *
+ * @param dst The result, it may alias the input matrix.
+ * @param matrix The input matrix.
+ * @param func The derivative of the activation function.
+ * @throws std::logic_error if the matrix is empty.
+ */
+template <typename T>
+void ActivateDerivativeInto(BasicMatrix<T>& dst, const MatrixOf<T>& matrix,
+                            activation_derivative func) {
+  if (matrix.IsEmpty()) {
+    throw std::logic_error("Matrix have inconsistent dimensions");
+  }
+  if (const std::optional<Activation> activation =
+          FindActivationDerivative(func)) {
+    ActivateDerivativeInto(dst, matrix, *activation);
+    return;
+  }
+  dst.Resize(matrix.GetRows(), matrix.GetCols());
+  std::transform(matrix.begin(), matrix.end(), dst.begin(),
+                 [&](T x) { return T(ApplyActivationDerivative(x, func)); });
+}
+
+template <typename T>
+void ActivateDerivativeInto(BasicMatrix<T>& dst, const MatrixOf<T>& matrix,
+                            Activation activation) {
+  if (matrix.IsEmpty()) {
+    throw std::logic_error("Matrix have inconsistent dimensions");
+  }
+  dst.Resize(matrix.GetRows(), matrix.GetCols());
+  const BasicSimdKernels<T>& kernels = GetSimdKernels<T>();
+  ActivationDerivativeKernel(activation, kernels)(matrix.Data(), dst.Data(),
+                                                 matrix.GetSize());
 }
 
 /**
@@ -408,7 +760,10 @@ Matrix operator*(const Matrix& matrix, const double d) {
  * @param m1 The first input matrix.
  * @param m2 The second input matrix.
  */
-void operator-=(Matrix& m1, const Matrix& m2) { m1 = m1 - m2; }
+template <typename T>
+void operator-=(BasicMatrix<T>& m1, const MatrixOf<T>& m2) {
+  SubInPlace(m1, m2);
+}
 
 /**
  * Prints all elements of a given vector to the standard output stream.
@@ -427,11 +782,119 @@ void PrintVector(const Vector& vector) {
  *
  * @param matrix The matrix to print.
  */
-void PrintMatrix(const Matrix& matrix) {
-  for (const auto& vector : matrix) {
-    PrintVector(vector);
+template <typename T>
+void PrintMatrix(const BasicMatrix<T>& matrix) {
+  for (std::size_t i = 0; i < matrix.GetRows(); ++i) {
+    for (std::size_t j = 0; j < matrix.GetCols(); ++j) {
+      std::cout << matrix(i, j) << ' ';
+    }
+    std::cout << '\n';
   }
   std::cout << '\n';
 }
 
+template Matrix BinaryOp(
+    const Matrix&, const Matrix&,
+    void (*)(const double*, const double*, double*, std::size_t));
+template Matrix Addition(const Matrix&, const Matrix&);
+template Matrix Subtraction(const Matrix&, const Matrix&);
+template Matrix Multiplication(const Matrix&, const Matrix&);
+template Matrix MultiplyHadamard(const Matrix&, const Matrix&);
+template Matrix MultiplyNumber(const Matrix&, const double);
+template Matrix Activate(const Matrix&, activation_func);
+template Matrix Activate(const Matrix&, Activation, MathMode);
+template Matrix ActivateDerivative(const Matrix&, activation_derivative);
+template Matrix ActivateDerivative(const Matrix&, Activation);
+template void ActivateLayer(const Matrix&, const Matrix&, const Matrix&,
+                            activation_func, Matrix&);
+template void ActivateLayer(const Matrix&, const Matrix&, const Matrix&,
+                            Activation, Matrix&, MathMode);
+template Matrix Multiply(const Matrix&, const Matrix&);
+template Matrix MultiplyTN(const Matrix&, const Matrix&);
+template Matrix MultiplyNT(const Matrix&, const Matrix&);
+template Matrix MultiplyWinograd(const Matrix&, const Matrix&);
+template void RandomizeMatrix(Matrix&);
+template void AddInPlace(Matrix&, const Matrix&);
+template void SubInPlace(Matrix&, const Matrix&);
+template void MultiplyHadamardInPlace(Matrix&, const Matrix&);
+template void MultiplyNumberInPlace(Matrix&, double);
+template void AxpyInto(Matrix&, double, const Matrix&);
+template void SubtractInto(Matrix&, const Matrix&, const Matrix&);
+template void MultiplyInto(Matrix&, const Matrix&, const Matrix&, double,
+                           double);
+template void MultiplyTNInto(Matrix&, const Matrix&, const Matrix&, double,
+                             double);
+template void MultiplyNTInto(Matrix&, const Matrix&, const Matrix&, double,
+                             double);
+template void GerInto(Matrix&, double, const Matrix&, const Matrix&);
+template void ActivateInto(Matrix&, const Matrix&, activation_func);
+template void ActivateInto(Matrix&, const Matrix&, Activation, MathMode);
+template void ActivateDerivativeInto(Matrix&, const Matrix&,
+                                     activation_derivative);
+template void ActivateDerivativeInto(Matrix&, const Matrix&, Activation);
+template void operator-=(Matrix&, const Matrix&);
+template void ComputeRowFactors(const Matrix&, std::vector<double>&);
+template void ComputeColFactors(const Matrix&, std::vector<double>&);
+template void ComputeResultMatrix(const Matrix&, const Matrix&,
+                                  const std::vector<double>&,
+                                  const std::vector<double>&, Matrix&,
+                                  std::size_t, std::size_t, std::size_t,
+                                  std::size_t);
+template void PrintMatrix(const Matrix&);
+
+template FloatMatrix BinaryOp(
+    const FloatMatrix&, const FloatMatrix&,
+    void (*)(const float*, const float*, float*, std::size_t));
+template FloatMatrix Addition(const FloatMatrix&, const FloatMatrix&);
+template FloatMatrix Subtraction(const FloatMatrix&, const FloatMatrix&);
+template FloatMatrix Multiplication(const FloatMatrix&, const FloatMatrix&);
+template FloatMatrix MultiplyHadamard(const FloatMatrix&, const FloatMatrix&);
+template FloatMatrix MultiplyNumber(const FloatMatrix&, const double);
+template FloatMatrix Activate(const FloatMatrix&, activation_func);
+template FloatMatrix Activate(const FloatMatrix&, Activation, MathMode);
+template FloatMatrix ActivateDerivative(const FloatMatrix&,
+                                        activation_derivative);
+template FloatMatrix ActivateDerivative(const FloatMatrix&, Activation);
+template void ActivateLayer(const FloatMatrix&, const FloatMatrix&,
+                            const FloatMatrix&, activation_func, FloatMatrix&);
+template void ActivateLayer(const FloatMatrix&, const FloatMatrix&,
+                            const FloatMatrix&, Activation, FloatMatrix&,
+                            MathMode);
+template FloatMatrix Multiply(const FloatMatrix&, const FloatMatrix&);
+template FloatMatrix MultiplyTN(const FloatMatrix&, const FloatMatrix&);
+template FloatMatrix MultiplyNT(const FloatMatrix&, const FloatMatrix&);
+template FloatMatrix MultiplyWinograd(const FloatMatrix&, const FloatMatrix&);
+template void RandomizeMatrix(FloatMatrix&);
+template void AddInPlace(FloatMatrix&, const FloatMatrix&);
+template void SubInPlace(FloatMatrix&, const FloatMatrix&);
+template void MultiplyHadamardInPlace(FloatMatrix&, const FloatMatrix&);
+template void MultiplyNumberInPlace(FloatMatrix&, double);
+template void AxpyInto(FloatMatrix&, double, const FloatMatrix&);
+template void SubtractInto(FloatMatrix&, const FloatMatrix&,
+                           const FloatMatrix&);
+template void MultiplyInto(FloatMatrix&, const FloatMatrix&, const FloatMatrix&,
+                           double, double);
+template void MultiplyTNInto(FloatMatrix&, const FloatMatrix&,
+                             const FloatMatrix&, double, double);
+template void MultiplyNTInto(FloatMatrix&, const FloatMatrix&,
+                             const FloatMatrix&, double, double);
+template void GerInto(FloatMatrix&, double, const FloatMatrix&,
+                      const FloatMatrix&);
+template void ActivateInto(FloatMatrix&, const FloatMatrix&, activation_func);
+template void ActivateInto(FloatMatrix&, const FloatMatrix&, Activation,
+                           MathMode);
+template void ActivateDerivativeInto(FloatMatrix&, const FloatMatrix&,
+                                     activation_derivative);
+template void ActivateDerivativeInto(FloatMatrix&, const FloatMatrix&,
+                                     Activation);
+template void operator-=(FloatMatrix&, const FloatMatrix&);
+template void ComputeRowFactors(const FloatMatrix&, std::vector<float>&);
+template void ComputeColFactors(const FloatMatrix&, std::vector<float>&);
+template void ComputeResultMatrix(const FloatMatrix&, const FloatMatrix&,
+                                  const std::vector<float>&,
+                                  const std::vector<float>&, FloatMatrix&,
+                                  std::size_t, std::size_t, std::size_t,
+                                  std::size_t);
+template void PrintMatrix(const FloatMatrix&);
+
 }  // namespace s21
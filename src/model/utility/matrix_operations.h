@@ -5,49 +5,140 @@
 #include <iostream>
 #include <random>
 #include <stdexcept>
-#include <thread>
 #include <vector>
 
 #include "activation_functions.h"
+#include "gemm.h"
+#include "matrix.h"
+#include "matrix_expression.h"
+#include "simd.h"
+#include "thread_pool.h"
 
 namespace s21 {
 
-using Vector = std::vector<double>;
-using Matrix = std::vector<Vector>;
-using Threads = std::vector<std::thread>;
-
-// Use Winograd algorithm for large matrices to improve performance.
-constexpr int kWinogradThreshold = 200;
-
-template <typename Op>
-Matrix BinaryOp(const Matrix &, const Matrix &, Op);
-Matrix Addition(const Matrix &, const Matrix &);
-Matrix Subtraction(const Matrix &, const Matrix &);
-Matrix Multiplication(const Matrix &, const Matrix &);
-Matrix MultiplyHadamard(const Matrix &, const Matrix &);
-Matrix MultiplyNumber(const Matrix &, const double);
-Matrix Transpose(const Matrix &);
-Matrix Activate(const Matrix &, activation_func);
-Matrix ActivateDerivative(const Matrix &, activation_derivative);
-Matrix Multiply(const Matrix &, const Matrix &);
-Matrix MultiplyWinograd(const Matrix &, const Matrix &);
-void RandomizeMatrix(Matrix &);
+// Side of the tiles of the result computed by one task of MultiplyWinograd.
+constexpr std::size_t kWinogradTile = 64;
+
+// Rank-1 updates of at least kGerParallelWork elements are split between the
+// threads by blocks of kGerRows rows.
+constexpr std::size_t kGerParallelWork = 1 << 17;
+constexpr std::size_t kGerRows = 64;
+
+// The operations are templates over the scalar type of the matrices and are
+// instantiated for float and double. Scalar arguments are passed as double.
+// The scalar type is deduced from the first matrix only; the others are
+// declared as MatrixOf<T>, so lazy expressions are still accepted for them.
+template <typename T>
+struct MatrixOfType {
+  using Type = BasicMatrix<T>;
+};
+
+template <typename T>
+using MatrixOf = typename MatrixOfType<T>::Type;
+
+template <typename Op, typename T>
+BasicMatrix<T> BinaryOp(const BasicMatrix<T> &, const MatrixOf<T> &, Op);
+template <typename T>
+BasicMatrix<T> BinaryOp(const BasicMatrix<T> &, const MatrixOf<T> &,
+                        void (*)(const T *, const T *, T *, std::size_t));
+template <typename T>
+BasicMatrix<T> Addition(const BasicMatrix<T> &, const MatrixOf<T> &);
+template <typename T>
+BasicMatrix<T> Subtraction(const BasicMatrix<T> &, const MatrixOf<T> &);
+template <typename T>
+BasicMatrix<T> Multiplication(const BasicMatrix<T> &, const MatrixOf<T> &);
+template <typename T>
+BasicMatrix<T> MultiplyHadamard(const BasicMatrix<T> &, const MatrixOf<T> &);
+template <typename T>
+BasicMatrix<T> MultiplyNumber(const BasicMatrix<T> &, const double);
+// Activations given as function pointers are mapped to the kernels of the
+// SIMD dispatch table when they are known ones, any other function is called
+// for each element. They use the exact sigmoid.
+template <typename T>
+BasicMatrix<T> Activate(const BasicMatrix<T> &, activation_func);
+template <typename T>
+BasicMatrix<T> Activate(const BasicMatrix<T> &, Activation,
+                        MathMode = MathMode::kExact);
+template <typename T>
+BasicMatrix<T> ActivateDerivative(const BasicMatrix<T> &,
+                                  activation_derivative);
+template <typename T>
+BasicMatrix<T> ActivateDerivative(const BasicMatrix<T> &, Activation);
+template <typename T>
+void ActivateLayer(const BasicMatrix<T> &, const MatrixOf<T> &,
+                   const MatrixOf<T> &, activation_func, BasicMatrix<T> &);
+template <typename T>
+void ActivateLayer(const BasicMatrix<T> &, const MatrixOf<T> &,
+                   const MatrixOf<T> &, Activation, BasicMatrix<T> &,
+                   MathMode = MathMode::kExact);
+template <typename T>
+BasicMatrix<T> Multiply(const BasicMatrix<T> &, const MatrixOf<T> &);
+template <typename T>
+BasicMatrix<T> MultiplyTN(const BasicMatrix<T> &, const MatrixOf<T> &);
+template <typename T>
+BasicMatrix<T> MultiplyNT(const BasicMatrix<T> &, const MatrixOf<T> &);
+template <typename T>
+BasicMatrix<T> MultiplyWinograd(const BasicMatrix<T> &, const MatrixOf<T> &);
+template <typename T>
+void RandomizeMatrix(BasicMatrix<T> &);
 void RandomizeVector(Vector &);
 double RandomWeight();
+void SeedRandomWeights(unsigned);
+
+// In-place operations, they reuse the storage of the destination and do not
+// allocate memory once it has reached its size.
+template <typename T>
+void AddInPlace(BasicMatrix<T> &, const MatrixOf<T> &);
+template <typename T>
+void SubInPlace(BasicMatrix<T> &, const MatrixOf<T> &);
+template <typename T>
+void MultiplyHadamardInPlace(BasicMatrix<T> &, const MatrixOf<T> &);
+template <typename T>
+void MultiplyNumberInPlace(BasicMatrix<T> &, double);
+template <typename T>
+void AxpyInto(BasicMatrix<T> &, double, const MatrixOf<T> &);
+template <typename T>
+void SubtractInto(BasicMatrix<T> &, const MatrixOf<T> &, const MatrixOf<T> &);
+template <typename T>
+void MultiplyInto(BasicMatrix<T> &, const MatrixOf<T> &, const MatrixOf<T> &,
+                  double alpha = 1.0, double beta = 0.0);
+template <typename T>
+void MultiplyTNInto(BasicMatrix<T> &, const MatrixOf<T> &, const MatrixOf<T> &,
+                    double alpha = 1.0, double beta = 0.0);
+template <typename T>
+void MultiplyNTInto(BasicMatrix<T> &, const MatrixOf<T> &, const MatrixOf<T> &,
+                    double alpha = 1.0, double beta = 0.0);
+template <typename T>
+void GerInto(BasicMatrix<T> &, double, const MatrixOf<T> &,
+             const MatrixOf<T> &);
+template <typename T>
+void ActivateInto(BasicMatrix<T> &, const MatrixOf<T> &, activation_func);
+template <typename T>
+void ActivateInto(BasicMatrix<T> &, const MatrixOf<T> &, Activation,
+                  MathMode = MathMode::kExact);
+template <typename T>
+void ActivateDerivativeInto(BasicMatrix<T> &, const MatrixOf<T> &,
+                            activation_derivative);
+template <typename T>
+void ActivateDerivativeInto(BasicMatrix<T> &, const MatrixOf<T> &,
+                            Activation);
 
-Matrix operator+(const Matrix &, const Matrix &);
-Matrix operator-(const Matrix &, const Matrix &);
-Matrix operator*(const Matrix &, const Matrix &);
-Matrix operator*(const Matrix &, const double);
-void operator-=(Matrix &, const Matrix &);
+template <typename T>
+void operator-=(BasicMatrix<T> &, const MatrixOf<T> &);
 
-void ComputeRowFactors(const Matrix &, Vector &);
-void ComputeColFactors(const Matrix &, Vector &);
-void ComputeResultMatrix(const Matrix &, const Matrix &, const Vector &,
-                         const Vector &, Matrix &, std::size_t, std::size_t);
+template <typename T>
+void ComputeRowFactors(const BasicMatrix<T> &, std::vector<T> &);
+template <typename T>
+void ComputeColFactors(const BasicMatrix<T> &, std::vector<T> &);
+template <typename T>
+void ComputeResultMatrix(const BasicMatrix<T> &, const MatrixOf<T> &,
+                         const std::vector<T> &, const std::vector<T> &,
+                         BasicMatrix<T> &, std::size_t, std::size_t,
+                         std::size_t, std::size_t);
 
 void PrintVector(const Vector &);
-void PrintMatrix(const Matrix &);
+template <typename T>
+void PrintMatrix(const BasicMatrix<T> &);
 
 }  // namespace s21
 
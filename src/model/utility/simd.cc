@@ -0,0 +1,135 @@
+#include "simd.h"
+
+#include <atomic>
+
+#include "static_kernels.h"
+
+namespace s21 {
+
+namespace {
+
+template <typename T>
+const BasicSimdKernels<T>* GetKernels(SimdLevel level) {
+  switch (level) {
+    case SimdLevel::kAvx512:
+      return GetAvx512Kernels<T>();
+    case SimdLevel::kAvx2:
+      return GetAvx2Kernels<T>();
+    case SimdLevel::kSse42:
+      return GetSse42Kernels<T>();
+    default:
+      return GetScalarKernels<T>();
+  }
+}
+
+template <typename T>
+std::atomic<const BasicSimdKernels<T>*>& ActiveKernels() {
+  static std::atomic<const BasicSimdKernels<T>*> kernels{
+      GetKernels<T>(DetectSimdLevel())};
+  return kernels;
+}
+
+}  // namespace
+
+/**
+ * Detects the widest instruction set that is both supported by the CPU and
+ * compiled into the binary.
+ *
+ * @return The detected instruction set level.
+ */
+SimdLevel DetectSimdLevel() {
+#if defined(__x86_64__) or defined(__i386__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") and
+      __builtin_cpu_supports("avx512bw") and GetAvx512Kernels()) {
+    return SimdLevel::kAvx512;
+  }
+  if (__builtin_cpu_supports("avx2") and __builtin_cpu_supports("fma") and
+      GetAvx2Kernels()) {
+    return SimdLevel::kAvx2;
+  }
+  if (__builtin_cpu_supports("sse4.2") and GetSse42Kernels()) {
+    return SimdLevel::kSse42;
+  }
+#endif
+  return SimdLevel::kScalar;
+}
+
+/**
+ * Returns the instruction set level of the kernels currently in use.
+ *
+ * @return The active instruction set level.
+ */
+SimdLevel GetSimdLevel() { return GetSimdKernels().level; }
+
+/**
+ * Selects the kernels of the given instruction set for both scalar types.
+ * Levels wider than the detected one are clamped, so the call is safe on any
+ * host. Mainly used to test and benchmark the narrower kernels.
+ *
+ * @param level The requested instruction set level.
+ */
+void SetSimdLevel(SimdLevel level) {
+  if (level > DetectSimdLevel()) level = DetectSimdLevel();
+  while (GetKernels<double>(level) == nullptr) {
+    level = static_cast<SimdLevel>(static_cast<int>(level) - 1);
+  }
+  ActiveKernels<double>().store(GetKernels<double>(level));
+  ActiveKernels<float>().store(GetKernels<float>(level));
+}
+
+/**
+ * Returns the kernels of the static layer shapes compiled for the
+ * instruction set currently in use.
+ *
+ * @return The kernels, in the order of StaticLayerShapes.
+ */
+const StaticLayerKernels* GetStaticKernels() {
+  switch (GetSimdLevel()) {
+    case SimdLevel::kAvx512:
+      return GetAvx512StaticKernels();
+    case SimdLevel::kAvx2:
+      return GetAvx2StaticKernels();
+    case SimdLevel::kSse42:
+      return GetSse42StaticKernels();
+    default:
+      return GetScalarStaticKernels();
+  }
+}
+
+/**
+ * Returns a human readable name of an instruction set level.
+ *
+ * @param level The instruction set level.
+ * @return The name of the level.
+ */
+const char* GetSimdLevelName(SimdLevel level) {
+  switch (level) {
+    case SimdLevel::kAvx512:
+      return "AVX-512";
+    case SimdLevel::kAvx2:
+      return "AVX2";
+    case SimdLevel::kSse42:
+      return "SSE4.2";
+    default:
+      return "Scalar";
+  }
+}
+
+/**
+ * Returns the dispatch table of the active instruction set. The table of the
+ * widest supported set is selected on the first call.
+ *
+ * @return The active kernels.
+ */
+template <>
+const BasicSimdKernels<double>& GetSimdKernels() {
+  return *ActiveKernels<double>().load(std::memory_order_relaxed);
+}
+
+template <>
+const BasicSimdKernels<float>& GetSimdKernels() {
+  return *ActiveKernels<float>().load(std::memory_order_relaxed);
+}
+
+}  // namespace s21
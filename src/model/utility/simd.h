@@ -0,0 +1,150 @@
+#ifndef MLP_MODEL_UTILITY_SIMD_H_
+#define MLP_MODEL_UTILITY_SIMD_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace s21 {
+
+/**
+ * @enum SimdLevel
+ * @brief Instruction set extensions the kernels are compiled for, ordered
+ * from the narrowest to the widest.
+ */
+enum class SimdLevel { kScalar, kSse42, kAvx2, kAvx512 };
+
+/**
+ * @enum MathMode
+ * @brief How the sigmoid evaluates its exponential: kExact calls the C
+ * library for every element, kFast uses the vectorized polynomial of the
+ * fast_exp kernel, whose relative error is below 2e-14 for double and 5e-7
+ * for float. Every model keeps its own mode.
+ */
+enum class MathMode { kExact, kFast };
+
+/**
+ * @struct BasicUpdateStep
+ * @brief Coefficients of one fused optimizer update. The gradients are
+ * multiplied by scale before being used; lr already includes the bias
+ * correction of Adam and beta1 is the momentum of the momentum updates.
+ */
+template <typename T>
+struct BasicUpdateStep {
+  T lr;
+  T scale;
+  T beta1;
+  T beta2;
+  T epsilon;
+};
+
+/**
+ * @struct BasicSimdKernels
+ * @brief Dispatch table of element-wise and GEMM kernels for one instruction
+ * set and one scalar type.
+ *
+ * Every instruction set lives in its own translation unit compiled with the
+ * matching target flags. The table of the widest set supported by the CPU is
+ * selected once on first use, so a single binary runs on every x86-64 host.
+ * Element-wise kernels work on flat arrays of n elements, the output may
+ * alias any of the inputs.
+ */
+template <typename T>
+struct BasicSimdKernels {
+  using Binary = void (*)(const T *, const T *, T *, std::size_t);
+  using Unary = void (*)(const T *, T *, std::size_t);
+  using Scale = void (*)(const T *, T, T *, std::size_t);
+  using Axpy = void (*)(T, const T *, T *, std::size_t);
+  using Dot = T (*)(const T *, const T *, std::size_t);
+  using MicroKernel = void (*)(std::size_t, const T *, const T *, T *);
+  using DotU8S8 = std::int32_t (*)(const std::uint8_t *, const std::int8_t *,
+                                   std::size_t);
+  using Update = void (*)(const T *, const BasicUpdateStep<T> &, T *, T *, T *,
+                          std::size_t);
+
+  SimdLevel level;
+  Binary add;
+  Binary sub;
+  Binary mul;
+  Scale scale;
+  Axpy axpy;
+  Dot dot;
+  Unary sigmoid;
+  Unary sigmoid_derivative;
+  // Polynomial exponential and sigmoid, see MathMode.
+  Unary fast_exp;
+  Unary fast_sigmoid;
+  Unary tanh;
+  Unary tanh_derivative;
+  Unary relu;
+  Unary relu_derivative;
+  // Update n parameters in place from their gradients in a single pass,
+  // together with the first moments (the velocities) and, for Adam, the
+  // second moments: update(gradients, step, parameters, first, second, n).
+  // The momentum kernels do not touch the second moments.
+  Update momentum;
+  Update nesterov;
+  Update adam;
+  // Computes an mr x nr tile from packed slivers of A and B into a
+  // contiguous buffer with a row stride of nr.
+  MicroKernel gemm;
+  std::size_t gemm_mr;
+  std::size_t gemm_nr;
+  // Dot product of unsigned and signed 8-bit integers accumulated in 32 bits,
+  // the same for both scalar types. The unsigned operand must not exceed
+  // kMaxDotU8 so the pairwise 16-bit sums of maddubs never saturate and every
+  // instruction set returns the exact result.
+  DotU8S8 dot_u8s8;
+};
+
+constexpr std::uint8_t kMaxDotU8 = 127;
+
+using SimdKernels = BasicSimdKernels<double>;
+
+// Upper bounds of the register tile over all instruction sets: two of the
+// widest vectors per row of the tile.
+constexpr std::size_t kMaxGemmMr = 8;
+template <typename T>
+constexpr std::size_t kMaxGemmNrOf = 128 / sizeof(T);
+constexpr std::size_t kMaxGemmNr = kMaxGemmNrOf<double>;
+
+SimdLevel DetectSimdLevel();
+SimdLevel GetSimdLevel();
+void SetSimdLevel(SimdLevel);
+const char *GetSimdLevelName(SimdLevel);
+
+// Tables are provided for float and double.
+template <typename T = double>
+const BasicSimdKernels<T> &GetSimdKernels();
+template <typename T = double>
+const BasicSimdKernels<T> *GetScalarKernels();
+template <typename T = double>
+const BasicSimdKernels<T> *GetSse42Kernels();
+template <typename T = double>
+const BasicSimdKernels<T> *GetAvx2Kernels();
+template <typename T = double>
+const BasicSimdKernels<T> *GetAvx512Kernels();
+
+template <>
+const BasicSimdKernels<double> &GetSimdKernels();
+template <>
+const BasicSimdKernels<float> &GetSimdKernels();
+template <>
+const BasicSimdKernels<double> *GetScalarKernels();
+template <>
+const BasicSimdKernels<float> *GetScalarKernels();
+template <>
+const BasicSimdKernels<double> *GetSse42Kernels();
+template <>
+const BasicSimdKernels<float> *GetSse42Kernels();
+template <>
+const BasicSimdKernels<double> *GetAvx2Kernels();
+template <>
+const BasicSimdKernels<float> *GetAvx2Kernels();
+template <>
+const BasicSimdKernels<double> *GetAvx512Kernels();
+template <>
+const BasicSimdKernels<float> *GetAvx512Kernels();
+
+}  // namespace s21
+
+#endif  // MLP_MODEL_UTILITY_SIMD_H_
@@ -0,0 +1,145 @@
+#include "simd.h"
+#include "static_kernels.h"
+
+#if defined(__AVX2__) and defined(__FMA__)
+
+#include <immintrin.h>
+
+#include "simd_kernels.h"
+
+namespace s21 {
+
+namespace {
+
+struct Avx2Pack {
+  using Scalar = double;
+  using Reg = __m256d;
+  static constexpr std::size_t kWidth = 4;
+
+  static Reg Load(const double *p) { return _mm256_loadu_pd(p); }
+  static void Store(double *p, Reg v) { _mm256_storeu_pd(p, v); }
+  static Reg Set1(double x) { return _mm256_set1_pd(x); }
+  static Reg Zero() { return _mm256_setzero_pd(); }
+  static Reg Add(Reg a, Reg b) { return _mm256_add_pd(a, b); }
+  static Reg Sub(Reg a, Reg b) { return _mm256_sub_pd(a, b); }
+  static Reg Mul(Reg a, Reg b) { return _mm256_mul_pd(a, b); }
+  static Reg Fmadd(Reg a, Reg b, Reg c) { return _mm256_fmadd_pd(a, b, c); }
+  static Reg Div(Reg a, Reg b) { return _mm256_div_pd(a, b); }
+  static Reg Max(Reg a, Reg b) { return _mm256_max_pd(a, b); }
+  static Reg Min(Reg a, Reg b) { return _mm256_min_pd(a, b); }
+  static Reg Sqrt(Reg a) { return _mm256_sqrt_pd(a); }
+  static Reg Round(Reg a) {
+    return _mm256_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  }
+  static Reg Pow2(Reg n) {
+    const __m256i biased =
+        _mm256_castpd_si256(_mm256_add_pd(n, Set1(kPow2Bias)));
+    return _mm256_castsi256_pd(_mm256_slli_epi64(biased, 52));
+  }
+  static Reg Step(Reg a) {
+    return _mm256_and_pd(_mm256_cmp_pd(a, Zero(), _CMP_GT_OQ), Set1(1.0));
+  }
+  static double ReduceAdd(Reg a) {
+    __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(a),
+                             _mm256_extractf128_pd(a, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+  }
+};
+
+struct Avx2FloatPack {
+  using Scalar = float;
+  using Reg = __m256;
+  static constexpr std::size_t kWidth = 8;
+
+  static Reg Load(const float *p) { return _mm256_loadu_ps(p); }
+  static void Store(float *p, Reg v) { _mm256_storeu_ps(p, v); }
+  static Reg Set1(float x) { return _mm256_set1_ps(x); }
+  static Reg Zero() { return _mm256_setzero_ps(); }
+  static Reg Add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+  static Reg Sub(Reg a, Reg b) { return _mm256_sub_ps(a, b); }
+  static Reg Mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+  static Reg Fmadd(Reg a, Reg b, Reg c) { return _mm256_fmadd_ps(a, b, c); }
+  static Reg Div(Reg a, Reg b) { return _mm256_div_ps(a, b); }
+  static Reg Max(Reg a, Reg b) { return _mm256_max_ps(a, b); }
+  static Reg Min(Reg a, Reg b) { return _mm256_min_ps(a, b); }
+  static Reg Sqrt(Reg a) { return _mm256_sqrt_ps(a); }
+  static Reg Round(Reg a) {
+    return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  }
+  static Reg Pow2(Reg n) {
+    const __m256i biased =
+        _mm256_castps_si256(_mm256_add_ps(n, Set1(kPow2BiasF)));
+    return _mm256_castsi256_ps(_mm256_slli_epi32(biased, 23));
+  }
+  static Reg Step(Reg a) {
+    return _mm256_and_ps(_mm256_cmp_ps(a, Zero(), _CMP_GT_OQ), Set1(1.0f));
+  }
+  static float ReduceAdd(Reg a) {
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(a),
+                            _mm256_extractf128_ps(a, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    return _mm_cvtss_f32(_mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1)));
+  }
+};
+
+std::int32_t Avx2DotU8S8(const std::uint8_t *a, const std::int8_t *b,
+                         std::size_t n) {
+  const __m256i ones = _mm256_set1_epi16(1);
+  __m256i acc = _mm256_setzero_si256();
+  std::size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+    acc = _mm256_add_epi32(
+        acc, _mm256_madd_epi16(_mm256_maddubs_epi16(va, vb), ones));
+  }
+  __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc),
+                              _mm256_extracti128_si256(acc, 1));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4e));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xb1));
+  return _mm_cvtsi128_si32(sum) + DotU8S8Tail(a, b, i, n);
+}
+
+constexpr BasicSimdKernels<double> kAvx2Kernels =
+    MakeKernels<Avx2Pack, 6, 8>(SimdLevel::kAvx2, Avx2DotU8S8);
+constexpr BasicSimdKernels<float> kAvx2FloatKernels =
+    MakeKernels<Avx2FloatPack, 6, 16>(SimdLevel::kAvx2, Avx2DotU8S8);
+constexpr StaticKernelTable kAvx2StaticKernels = MakeStaticKernels<Avx2Pack>();
+
+}  // namespace
+
+template <>
+const BasicSimdKernels<double> *GetAvx2Kernels() {
+  return &kAvx2Kernels;
+}
+
+template <>
+const BasicSimdKernels<float> *GetAvx2Kernels() {
+  return &kAvx2FloatKernels;
+}
+
+const StaticLayerKernels *GetAvx2StaticKernels() {
+  return kAvx2StaticKernels.layers;
+}
+
+}  // namespace s21
+
+#else
+
+namespace s21 {
+
+template <>
+const BasicSimdKernels<double> *GetAvx2Kernels() {
+  return nullptr;
+}
+
+template <>
+const BasicSimdKernels<float> *GetAvx2Kernels() {
+  return nullptr;
+}
+
+const StaticLayerKernels *GetAvx2StaticKernels() { return nullptr; }
+
+}  // namespace s21
+
+#endif  // __AVX2__ and __FMA__
@@ -0,0 +1,171 @@
+#include "simd.h"
+#include "static_kernels.h"
+
+#if defined(__AVX512F__) and defined(__AVX512BW__)
+
+// GCC 12 reports the intentionally undefined registers of the AVX-512
+// intrinsics headers as uninitialized (GCC bug 105593).
+#if defined(__GNUC__) and !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+#include <immintrin.h>
+
+#include "simd_kernels.h"
+
+namespace s21 {
+
+namespace {
+
+struct Avx512Pack {
+  using Scalar = double;
+  using Reg = __m512d;
+  static constexpr std::size_t kWidth = 8;
+
+  static Reg Load(const double *p) { return _mm512_loadu_pd(p); }
+  static void Store(double *p, Reg v) { _mm512_storeu_pd(p, v); }
+  static Reg Set1(double x) { return _mm512_set1_pd(x); }
+  static Reg Zero() { return _mm512_setzero_pd(); }
+  static Reg Add(Reg a, Reg b) { return _mm512_add_pd(a, b); }
+  static Reg Sub(Reg a, Reg b) { return _mm512_sub_pd(a, b); }
+  static Reg Mul(Reg a, Reg b) { return _mm512_mul_pd(a, b); }
+  static Reg Fmadd(Reg a, Reg b, Reg c) { return _mm512_fmadd_pd(a, b, c); }
+  static Reg Div(Reg a, Reg b) { return _mm512_div_pd(a, b); }
+  static Reg Max(Reg a, Reg b) { return _mm512_max_pd(a, b); }
+  static Reg Min(Reg a, Reg b) { return _mm512_min_pd(a, b); }
+  static Reg Sqrt(Reg a) { return _mm512_sqrt_pd(a); }
+  static Reg Round(Reg a) {
+    return _mm512_roundscale_pd(a,
+                                _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  }
+  static Reg Pow2(Reg n) {
+    const __m512i biased =
+        _mm512_castpd_si512(_mm512_add_pd(n, Set1(kPow2Bias)));
+    return _mm512_castsi512_pd(_mm512_slli_epi64(biased, 52));
+  }
+  static Reg Step(Reg a) {
+    return _mm512_maskz_mov_pd(_mm512_cmp_pd_mask(a, Zero(), _CMP_GT_OQ),
+                               Set1(1.0));
+  }
+  static double ReduceAdd(Reg a) { return _mm512_reduce_add_pd(a); }
+};
+
+struct Avx512FloatPack {
+  using Scalar = float;
+  using Reg = __m512;
+  static constexpr std::size_t kWidth = 16;
+
+  static Reg Load(const float *p) { return _mm512_loadu_ps(p); }
+  static void Store(float *p, Reg v) { _mm512_storeu_ps(p, v); }
+  static Reg Set1(float x) { return _mm512_set1_ps(x); }
+  static Reg Zero() { return _mm512_setzero_ps(); }
+  static Reg Add(Reg a, Reg b) { return _mm512_add_ps(a, b); }
+  static Reg Sub(Reg a, Reg b) { return _mm512_sub_ps(a, b); }
+  static Reg Mul(Reg a, Reg b) { return _mm512_mul_ps(a, b); }
+  static Reg Fmadd(Reg a, Reg b, Reg c) { return _mm512_fmadd_ps(a, b, c); }
+  static Reg Div(Reg a, Reg b) { return _mm512_div_ps(a, b); }
+  static Reg Max(Reg a, Reg b) { return _mm512_max_ps(a, b); }
+  static Reg Min(Reg a, Reg b) { return _mm512_min_ps(a, b); }
+  static Reg Sqrt(Reg a) { return _mm512_sqrt_ps(a); }
+  static Reg Round(Reg a) {
+    return _mm512_roundscale_ps(a,
+                                _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  }
+  static Reg Pow2(Reg n) {
+    const __m512i biased =
+        _mm512_castps_si512(_mm512_add_ps(n, Set1(kPow2BiasF)));
+    return _mm512_castsi512_ps(_mm512_slli_epi32(biased, 23));
+  }
+  static Reg Step(Reg a) {
+    return _mm512_maskz_mov_ps(_mm512_cmp_ps_mask(a, Zero(), _CMP_GT_OQ),
+                               Set1(1.0f));
+  }
+  static float ReduceAdd(Reg a) { return _mm512_reduce_add_ps(a); }
+};
+
+std::int32_t Avx512DotU8S8(const std::uint8_t *a, const std::int8_t *b,
+                           std::size_t n) {
+  const __m512i ones = _mm512_set1_epi16(1);
+  __m512i acc = _mm512_setzero_si512();
+  std::size_t i = 0;
+  for (; i + 64 <= n; i += 64) {
+    __m512i va = _mm512_loadu_si512(a + i);
+    __m512i vb = _mm512_loadu_si512(b + i);
+    acc = _mm512_add_epi32(
+        acc, _mm512_madd_epi16(_mm512_maddubs_epi16(va, vb), ones));
+  }
+  return _mm512_reduce_add_epi32(acc) + DotU8S8Tail(a, b, i, n);
+}
+
+// VNNI fuses the three instructions above into vpdpbusd. It is an optional
+// extension of AVX-512, so the function is compiled for it separately and
+// only selected when the CPU reports it.
+__attribute__((target("avx512vnni"))) std::int32_t Avx512VnniDotU8S8(
+    const std::uint8_t *a, const std::int8_t *b, std::size_t n) {
+  __m512i acc = _mm512_setzero_si512();
+  std::size_t i = 0;
+  for (; i + 64 <= n; i += 64) {
+    acc = _mm512_dpbusd_epi32(acc, _mm512_loadu_si512(a + i),
+                              _mm512_loadu_si512(b + i));
+  }
+  return _mm512_reduce_add_epi32(acc) + DotU8S8Tail(a, b, i, n);
+}
+
+template <typename T>
+BasicSimdKernels<T> WithVnni(BasicSimdKernels<T> kernels) {
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512vnni")) {
+    kernels.dot_u8s8 = Avx512VnniDotU8S8;
+  }
+  return kernels;
+}
+
+constexpr BasicSimdKernels<double> kAvx512Kernels =
+    MakeKernels<Avx512Pack, 8, 16>(SimdLevel::kAvx512, Avx512DotU8S8);
+constexpr BasicSimdKernels<float> kAvx512FloatKernels =
+    MakeKernels<Avx512FloatPack, 8, 32>(SimdLevel::kAvx512,
+                                        Avx512DotU8S8);
+constexpr StaticKernelTable kAvx512StaticKernels =
+    MakeStaticKernels<Avx512Pack>();
+
+}  // namespace
+
+template <>
+const BasicSimdKernels<double> *GetAvx512Kernels() {
+  static const BasicSimdKernels<double> kernels = WithVnni(kAvx512Kernels);
+  return &kernels;
+}
+
+template <>
+const BasicSimdKernels<float> *GetAvx512Kernels() {
+  static const BasicSimdKernels<float> kernels =
+      WithVnni(kAvx512FloatKernels);
+  return &kernels;
+}
+
+const StaticLayerKernels *GetAvx512StaticKernels() {
+  return kAvx512StaticKernels.layers;
+}
+
+}  // namespace s21
+
+#else
+
+namespace s21 {
+
+template <>
+const BasicSimdKernels<double> *GetAvx512Kernels() {
+  return nullptr;
+}
+
+template <>
+const BasicSimdKernels<float> *GetAvx512Kernels() {
+  return nullptr;
+}
+
+const StaticLayerKernels *GetAvx512StaticKernels() { return nullptr; }
+
+}  // namespace s21
+
+#endif  // __AVX512F__ and __AVX512BW__
@@ -0,0 +1,610 @@
+#ifndef MLP_MODEL_UTILITY_SIMD_KERNELS_H_
+#define MLP_MODEL_UTILITY_SIMD_KERNELS_H_
+
+#include <math.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "simd.h"
+#include "static_kernels.h"
+
+// Generic kernel bodies shared by the per instruction set translation units.
+// Each unit defines a Pack type wrapping its vector registers and builds its
+// dispatch table from these templates. Everything here has internal linkage:
+// a function compiled with AVX flags must never be merged by the linker with
+// the copy used by the scalar fallback, so only include this header from the
+// simd_*.cc files and do not call inline library templates from the kernels.
+
+namespace s21 {
+namespace {
+
+// Adding these to an integral value n of the scalar type leaves n plus the
+// exponent bias in the low mantissa bits; shifting them into the exponent
+// field gives 2^n. Used by the Pow2 function of the packs.
+constexpr double kPow2Bias = 0x1p52 + 1023;
+constexpr float kPow2BiasF = 0x1p23f + 127;
+
+inline double Pow2Of(double n) {
+  std::uint64_t bits;
+  const double biased = n + kPow2Bias;
+  std::memcpy(&bits, &biased, sizeof(bits));
+  bits <<= 52;
+  double result;
+  std::memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+inline float Pow2Of(float n) {
+  std::uint32_t bits;
+  const float biased = n + kPow2BiasF;
+  std::memcpy(&bits, &biased, sizeof(bits));
+  bits <<= 23;
+  float result;
+  std::memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+inline double RoundOf(double x) { return nearbyint(x); }
+inline float RoundOf(float x) { return nearbyintf(x); }
+inline double SqrtOf(double x) { return sqrt(x); }
+inline float SqrtOf(float x) { return sqrtf(x); }
+
+/**
+ * @struct ScalarPack
+ * @brief Pack of a single scalar, used for loop tails and as the fallback.
+ */
+template <typename T>
+struct ScalarPack {
+  using Scalar = T;
+  using Reg = T;
+  static constexpr std::size_t kWidth = 1;
+
+  static Reg Load(const T *p) { return *p; }
+  static void Store(T *p, Reg v) { *p = v; }
+  static Reg Set1(T x) { return x; }
+  static Reg Zero() { return T{0}; }
+  static Reg Add(Reg a, Reg b) { return a + b; }
+  static Reg Sub(Reg a, Reg b) { return a - b; }
+  static Reg Mul(Reg a, Reg b) { return a * b; }
+  static Reg Fmadd(Reg a, Reg b, Reg c) { return a * b + c; }
+  static Reg Div(Reg a, Reg b) { return a / b; }
+  static Reg Max(Reg a, Reg b) { return a > b ? a : b; }
+  static Reg Min(Reg a, Reg b) { return a < b ? a : b; }
+  static Reg Sqrt(Reg a) { return SqrtOf(a); }
+  static Reg Round(Reg a) { return RoundOf(a); }
+  static Reg Pow2(Reg n) { return Pow2Of(n); }
+  static Reg Step(Reg a) { return a > T{0} ? T{1} : T{0}; }
+  static T ReduceAdd(Reg a) { return a; }
+};
+
+// The exponential and tanh of the C library; not the inline overloads of
+// <cmath>, which would be compiled with the flags of the including unit.
+inline double Exp(double x) { return exp(x); }
+inline float Exp(float x) { return expf(x); }
+inline double Tanh(double x) { return ::tanh(x); }
+inline float Tanh(float x) { return ::tanhf(x); }
+
+struct AddOp {
+  template <typename P>
+  static typename P::Reg Apply(typename P::Reg a, typename P::Reg b) {
+    return P::Add(a, b);
+  }
+};
+
+struct SubOp {
+  template <typename P>
+  static typename P::Reg Apply(typename P::Reg a, typename P::Reg b) {
+    return P::Sub(a, b);
+  }
+};
+
+struct MulOp {
+  template <typename P>
+  static typename P::Reg Apply(typename P::Reg a, typename P::Reg b) {
+    return P::Mul(a, b);
+  }
+};
+
+struct SigmoidDerivativeOp {
+  template <typename P>
+  static typename P::Reg Apply(typename P::Reg x) {
+    return P::Mul(x, P::Sub(P::Set1(1), x));
+  }
+};
+
+struct TanhDerivativeOp {
+  template <typename P>
+  static typename P::Reg Apply(typename P::Reg y) {
+    return P::Sub(P::Set1(1), P::Mul(y, y));
+  }
+};
+
+/**
+ * @struct ExpConstants
+ * @brief Parameters of the polynomial exponential for one scalar type: the
+ * clamped input range, which keeps 2^n a normal number, the split of ln 2
+ * whose high part has enough trailing zero bits for n * kLn2Hi to be exact,
+ * and the degree of the Taylor polynomial of e^r on |r| <= ln 2 / 2.
+ */
+template <typename T>
+struct ExpConstants;
+
+template <>
+struct ExpConstants<double> {
+  static constexpr double kMin = -708.0;
+  static constexpr double kMax = 708.0;
+  static constexpr double kLn2Hi = 0.693145751953125;
+  static constexpr double kLn2Lo = 1.42860682030941723212e-6;
+  static constexpr int kDegree = 11;
+};
+
+template <>
+struct ExpConstants<float> {
+  static constexpr float kMin = -87.0f;
+  static constexpr float kMax = 88.0f;
+  static constexpr float kLn2Hi = 0.693359375f;
+  static constexpr float kLn2Lo = -2.12194440e-4f;
+  static constexpr int kDegree = 6;
+};
+
+/**
+ * Vectorized exponential: x = n ln 2 + r with integral n, e^r from a Taylor
+ * polynomial evaluated by Horner's rule and 2^n built in the exponent bits.
+ * The truncation error of the polynomial is below r^(d+1) / (d+1)!, about
+ * 6e-15 for double and 1.2e-7 for float; with the rounding errors the
+ * relative error stays below 2e-14 and 5e-7, and the absolute error of the
+ * sigmoid below 5e-15 and 2e-7. Inputs are clamped to [kMin, kMax], so the
+ * results neither overflow to infinity nor underflow to zero.
+ */
+template <typename P, typename T = typename P::Scalar>
+typename P::Reg FastExp(typename P::Reg x) {
+  using Constants = ExpConstants<T>;
+  x = P::Min(P::Max(x, P::Set1(Constants::kMin)), P::Set1(Constants::kMax));
+  const auto n = P::Round(P::Mul(x, P::Set1(T(1.4426950408889634))));
+  auto r = P::Fmadd(n, P::Set1(-Constants::kLn2Hi), x);
+  r = P::Fmadd(n, P::Set1(-Constants::kLn2Lo), r);
+  double coefficient = 1.0;
+  for (int k = 2; k <= Constants::kDegree; ++k) coefficient /= k;
+  auto p = P::Set1(T(coefficient));
+  for (int k = Constants::kDegree; k-- > 0;) {
+    coefficient *= k + 1;
+    p = P::Fmadd(p, r, P::Set1(T(coefficient)));
+  }
+  return P::Mul(p, P::Pow2(n));
+}
+
+struct FastExpOp {
+  template <typename P>
+  static typename P::Reg Apply(typename P::Reg x) {
+    return FastExp<P>(x);
+  }
+};
+
+struct FastSigmoidOp {
+  template <typename P>
+  static typename P::Reg Apply(typename P::Reg x) {
+    const auto one = P::Set1(1);
+    return P::Div(one, P::Add(one, FastExp<P>(P::Sub(P::Zero(), x))));
+  }
+};
+
+struct ReluOp {
+  template <typename P>
+  static typename P::Reg Apply(typename P::Reg x) {
+    return P::Max(x, P::Zero());
+  }
+};
+
+struct ReluDerivativeOp {
+  template <typename P>
+  static typename P::Reg Apply(typename P::Reg x) {
+    return P::Step(x);
+  }
+};
+
+/**
+ * @struct UpdateConstants
+ * @brief Coefficients of a BasicUpdateStep broadcast to registers once per
+ * call of an update kernel.
+ */
+template <typename P, typename T = typename P::Scalar>
+struct UpdateConstants {
+  explicit UpdateConstants(const BasicUpdateStep<T> &step)
+      : neg_lr(P::Set1(-step.lr)),
+        scale(P::Set1(step.scale)),
+        beta1(P::Set1(step.beta1)),
+        rest1(P::Set1(T{1} - step.beta1)),
+        beta2(P::Set1(step.beta2)),
+        rest2(P::Set1(T{1} - step.beta2)),
+        epsilon(P::Set1(step.epsilon)) {}
+
+  typename P::Reg neg_lr, scale, beta1, rest1, beta2, rest2, epsilon;
+};
+
+// v = beta1 v + g, w -= lr v
+struct MomentumOp {
+  static constexpr bool kSecond = false;
+  template <typename P, typename Reg = typename P::Reg>
+  static void Apply(const UpdateConstants<P> &c, Reg g, Reg &w, Reg &v,
+                    Reg &) {
+    v = P::Fmadd(c.beta1, v, P::Mul(c.scale, g));
+    w = P::Fmadd(c.neg_lr, v, w);
+  }
+};
+
+// v = beta1 v + g, w -= lr (g + beta1 v)
+struct NesterovOp {
+  static constexpr bool kSecond = false;
+  template <typename P, typename Reg = typename P::Reg>
+  static void Apply(const UpdateConstants<P> &c, Reg g, Reg &w, Reg &v,
+                    Reg &) {
+    g = P::Mul(c.scale, g);
+    v = P::Fmadd(c.beta1, v, g);
+    w = P::Fmadd(c.neg_lr, P::Fmadd(c.beta1, v, g), w);
+  }
+};
+
+// m = beta1 m + (1 - beta1) g, s = beta2 s + (1 - beta2) g^2,
+// w -= lr m / (sqrt(s) + epsilon)
+struct AdamOp {
+  static constexpr bool kSecond = true;
+  template <typename P, typename Reg = typename P::Reg>
+  static void Apply(const UpdateConstants<P> &c, Reg g, Reg &w, Reg &m,
+                    Reg &s) {
+    g = P::Mul(c.scale, g);
+    m = P::Fmadd(c.beta1, m, P::Mul(c.rest1, g));
+    s = P::Fmadd(c.beta2, s, P::Mul(c.rest2, P::Mul(g, g)));
+    w = P::Fmadd(c.neg_lr, P::Div(m, P::Add(P::Sqrt(s), c.epsilon)), w);
+  }
+};
+
+/**
+ * Fused optimizer update: every element of the parameters, the gradients
+ * and the moments is loaded and stored once.
+ */
+template <typename P, typename Op, typename T = typename P::Scalar>
+void UpdateKernel(const T *g, const BasicUpdateStep<T> &step, T *w, T *m,
+                  T *s, std::size_t n) {
+  constexpr std::size_t kW = P::kWidth;
+  const UpdateConstants<P> constants(step);
+  std::size_t i = 0;
+  for (; i + kW <= n; i += kW) {
+    auto w_i = P::Load(w + i), m_i = P::Load(m + i);
+    auto s_i = Op::kSecond ? P::Load(s + i) : P::Zero();
+    Op::template Apply<P>(constants, P::Load(g + i), w_i, m_i, s_i);
+    P::Store(w + i, w_i);
+    P::Store(m + i, m_i);
+    if constexpr (Op::kSecond) P::Store(s + i, s_i);
+  }
+  const UpdateConstants<ScalarPack<T>> scalar(step);
+  for (; i < n; ++i) {
+    T s_i = Op::kSecond ? s[i] : T{0};
+    Op::template Apply<ScalarPack<T>>(scalar, g[i], w[i], m[i], s_i);
+    if constexpr (Op::kSecond) s[i] = s_i;
+  }
+}
+
+template <typename P, typename Op, typename T = typename P::Scalar>
+void BinaryKernel(const T *a, const T *b, T *r, std::size_t n) {
+  constexpr std::size_t kW = P::kWidth;
+  std::size_t i = 0;
+  for (; i + 2 * kW <= n; i += 2 * kW) {
+    auto r0 = Op::template Apply<P>(P::Load(a + i), P::Load(b + i));
+    auto r1 = Op::template Apply<P>(P::Load(a + i + kW), P::Load(b + i + kW));
+    P::Store(r + i, r0);
+    P::Store(r + i + kW, r1);
+  }
+  for (; i + kW <= n; i += kW) {
+    P::Store(r + i, Op::template Apply<P>(P::Load(a + i), P::Load(b + i)));
+  }
+  for (; i < n; ++i) {
+    r[i] = Op::template Apply<ScalarPack<T>>(a[i], b[i]);
+  }
+}
+
+template <typename P, typename Op, typename T = typename P::Scalar>
+void UnaryKernel(const T *x, T *r, std::size_t n) {
+  constexpr std::size_t kW = P::kWidth;
+  std::size_t i = 0;
+  for (; i + 2 * kW <= n; i += 2 * kW) {
+    auto r0 = Op::template Apply<P>(P::Load(x + i));
+    auto r1 = Op::template Apply<P>(P::Load(x + i + kW));
+    P::Store(r + i, r0);
+    P::Store(r + i + kW, r1);
+  }
+  for (; i + kW <= n; i += kW) {
+    P::Store(r + i, Op::template Apply<P>(P::Load(x + i)));
+  }
+  for (; i < n; ++i) {
+    r[i] = Op::template Apply<ScalarPack<T>>(x[i]);
+  }
+}
+
+template <typename P, typename T = typename P::Scalar>
+void ScaleKernel(const T *x, T d, T *r, std::size_t n) {
+  constexpr std::size_t kW = P::kWidth;
+  const auto scale = P::Set1(d);
+  std::size_t i = 0;
+  for (; i + 2 * kW <= n; i += 2 * kW) {
+    auto r0 = P::Mul(P::Load(x + i), scale);
+    auto r1 = P::Mul(P::Load(x + i + kW), scale);
+    P::Store(r + i, r0);
+    P::Store(r + i + kW, r1);
+  }
+  for (; i + kW <= n; i += kW) {
+    P::Store(r + i, P::Mul(P::Load(x + i), scale));
+  }
+  for (; i < n; ++i) {
+    r[i] = x[i] * d;
+  }
+}
+
+// y += a * x
+template <typename P, typename T = typename P::Scalar>
+void AxpyKernel(T a, const T *x, T *y, std::size_t n) {
+  constexpr std::size_t kW = P::kWidth;
+  const auto scale = P::Set1(a);
+  std::size_t i = 0;
+  for (; i + 2 * kW <= n; i += 2 * kW) {
+    auto y0 = P::Fmadd(scale, P::Load(x + i), P::Load(y + i));
+    auto y1 = P::Fmadd(scale, P::Load(x + i + kW), P::Load(y + i + kW));
+    P::Store(y + i, y0);
+    P::Store(y + i + kW, y1);
+  }
+  for (; i + kW <= n; i += kW) {
+    P::Store(y + i, P::Fmadd(scale, P::Load(x + i), P::Load(y + i)));
+  }
+  for (; i < n; ++i) {
+    y[i] += a * x[i];
+  }
+}
+
+template <typename P, typename T = typename P::Scalar>
+T DotKernel(const T *x, const T *y, std::size_t n) {
+  constexpr std::size_t kW = P::kWidth;
+  auto acc0 = P::Zero(), acc1 = P::Zero();
+  std::size_t i = 0;
+  for (; i + 2 * kW <= n; i += 2 * kW) {
+    acc0 = P::Fmadd(P::Load(x + i), P::Load(y + i), acc0);
+    acc1 = P::Fmadd(P::Load(x + i + kW), P::Load(y + i + kW), acc1);
+  }
+  for (; i + kW <= n; i += kW) {
+    acc0 = P::Fmadd(P::Load(x + i), P::Load(y + i), acc0);
+  }
+  T sum = P::ReduceAdd(P::Add(acc0, acc1));
+  for (; i < n; ++i) {
+    sum += x[i] * y[i];
+  }
+  return sum;
+}
+
+// Exact sigmoid, bounded by the scalar exponential of the C library.
+template <typename T>
+void SigmoidKernel(const T *x, T *r, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) {
+    r[i] = T{1} / (T{1} + Exp(-x[i]));
+  }
+}
+
+template <typename T>
+void TanhKernel(const T *x, T *r, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) r[i] = Tanh(x[i]);
+}
+
+/**
+ * Integer dot product of the elements [begin, n), used by the scalar kernel
+ * and for the tails of the vector ones.
+ */
+std::int32_t DotU8S8Tail(const std::uint8_t *a, const std::int8_t *b,
+                         std::size_t begin, std::size_t n) {
+  std::int32_t sum = 0;
+  for (std::size_t i = begin; i < n; ++i) {
+    sum += static_cast<std::int32_t>(a[i]) * static_cast<std::int32_t>(b[i]);
+  }
+  return sum;
+}
+
+/**
+ * Register-blocked GEMM micro-kernel. Keeps an MR x NR tile of accumulators
+ * in vector registers for the whole KC loop; every step broadcasts MR values
+ * of the packed A sliver and multiplies them by NR values of the B sliver.
+ */
+template <typename P, std::size_t MR, std::size_t NR,
+          typename T = typename P::Scalar>
+void GemmKernel(std::size_t kc, const T *a, const T *b, T *tile) {
+  constexpr std::size_t kVecs = NR / P::kWidth;
+  static_assert(NR % P::kWidth == 0, "NR must be a multiple of the width");
+  typename P::Reg acc[MR][kVecs];
+  for (std::size_t i = 0; i < MR; ++i) {
+    for (std::size_t v = 0; v < kVecs; ++v) acc[i][v] = P::Zero();
+  }
+  for (std::size_t k = 0; k < kc; ++k) {
+    typename P::Reg b_vecs[kVecs];
+    for (std::size_t v = 0; v < kVecs; ++v) {
+      b_vecs[v] = P::Load(b + v * P::kWidth);
+    }
+    for (std::size_t i = 0; i < MR; ++i) {
+      const auto a_i = P::Set1(a[i]);
+      for (std::size_t v = 0; v < kVecs; ++v) {
+        acc[i][v] = P::Fmadd(a_i, b_vecs[v], acc[i][v]);
+      }
+    }
+    a += MR;
+    b += NR;
+  }
+  for (std::size_t i = 0; i < MR; ++i) {
+    for (std::size_t v = 0; v < kVecs; ++v) {
+      P::Store(tile + i * NR + v * P::kWidth, acc[i][v]);
+    }
+  }
+}
+
+template <typename P, std::size_t MR, std::size_t NR,
+          typename T = typename P::Scalar>
+constexpr BasicSimdKernels<T> MakeKernels(
+    SimdLevel level, typename BasicSimdKernels<T>::DotU8S8 dot_u8s8) {
+  static_assert(MR <= kMaxGemmMr and NR <= kMaxGemmNrOf<T>,
+                "Tile is too large");
+  return {level,
+          BinaryKernel<P, AddOp>,
+          BinaryKernel<P, SubOp>,
+          BinaryKernel<P, MulOp>,
+          ScaleKernel<P>,
+          AxpyKernel<P>,
+          DotKernel<P>,
+          SigmoidKernel<T>,
+          UnaryKernel<P, SigmoidDerivativeOp>,
+          UnaryKernel<P, FastExpOp>,
+          UnaryKernel<P, FastSigmoidOp>,
+          TanhKernel<T>,
+          UnaryKernel<P, TanhDerivativeOp>,
+          UnaryKernel<P, ReluOp>,
+          UnaryKernel<P, ReluDerivativeOp>,
+          UpdateKernel<P, MomentumOp>,
+          UpdateKernel<P, NesterovOp>,
+          UpdateKernel<P, AdamOp>,
+          GemmKernel<P, MR, NR>,
+          MR,
+          NR,
+          dot_u8s8};
+}
+
+// Forward pass of a static layer: blocks of four registers of columns
+// accumulate the rows of all the inputs, then are stored once. Every column
+// gets the same multiply-adds in the same order as with AxpyKernel.
+template <typename P, std::size_t In, std::size_t Out>
+void StaticForwardKernel(const double *input, const double *weights,
+                         const double *biases, double *values) {
+  constexpr std::size_t kW = P::kWidth;
+  constexpr std::size_t kBlocksEnd = Out / (4 * kW) * (4 * kW);
+  constexpr std::size_t kVectorsEnd = Out / kW * kW;
+  std::size_t j = 0;
+  for (; j < kBlocksEnd; j += 4 * kW) {
+    auto v0 = P::Load(biases + j), v1 = P::Load(biases + j + kW);
+    auto v2 = P::Load(biases + j + 2 * kW), v3 = P::Load(biases + j + 3 * kW);
+    for (std::size_t i = 0; i < In; ++i) {
+      const auto x = P::Set1(input[i]);
+      const double *row = weights + i * Out + j;
+      v0 = P::Fmadd(x, P::Load(row), v0);
+      v1 = P::Fmadd(x, P::Load(row + kW), v1);
+      v2 = P::Fmadd(x, P::Load(row + 2 * kW), v2);
+      v3 = P::Fmadd(x, P::Load(row + 3 * kW), v3);
+    }
+    P::Store(values + j, v0);
+    P::Store(values + j + kW, v1);
+    P::Store(values + j + 2 * kW, v2);
+    P::Store(values + j + 3 * kW, v3);
+  }
+  for (; j < kVectorsEnd; j += kW) {
+    auto v = P::Load(biases + j);
+    for (std::size_t i = 0; i < In; ++i) {
+      v = P::Fmadd(P::Set1(input[i]), P::Load(weights + i * Out + j), v);
+    }
+    P::Store(values + j, v);
+  }
+  for (; j < Out; ++j) {
+    double v = biases[j];
+    for (std::size_t i = 0; i < In; ++i) {
+      v += input[i] * weights[i * Out + j];
+    }
+    values[j] = v;
+  }
+}
+
+// AxpyKernel and DotKernel of a constant length; the bounds of the loops are
+// constants so that no tail loop is left for a multiple of the width.
+template <typename P, std::size_t N>
+void StaticAxpyKernel(double a, const double *x, double *y) {
+  constexpr std::size_t kW = P::kWidth;
+  constexpr std::size_t kPairsEnd = N / (2 * kW) * (2 * kW);
+  constexpr std::size_t kVectorsEnd = N / kW * kW;
+  const auto scale = P::Set1(a);
+  std::size_t i = 0;
+  for (; i < kPairsEnd; i += 2 * kW) {
+    auto y0 = P::Fmadd(scale, P::Load(x + i), P::Load(y + i));
+    auto y1 = P::Fmadd(scale, P::Load(x + i + kW), P::Load(y + i + kW));
+    P::Store(y + i, y0);
+    P::Store(y + i + kW, y1);
+  }
+  for (; i < kVectorsEnd; i += kW) {
+    P::Store(y + i, P::Fmadd(scale, P::Load(x + i), P::Load(y + i)));
+  }
+  for (; i < N; ++i) {
+    y[i] += a * x[i];
+  }
+}
+
+template <typename P, std::size_t N>
+double StaticDotKernel(const double *x, const double *y) {
+  constexpr std::size_t kW = P::kWidth;
+  constexpr std::size_t kPairsEnd = N / (2 * kW) * (2 * kW);
+  constexpr std::size_t kVectorsEnd = N / kW * kW;
+  auto acc0 = P::Zero(), acc1 = P::Zero();
+  std::size_t i = 0;
+  for (; i < kPairsEnd; i += 2 * kW) {
+    acc0 = P::Fmadd(P::Load(x + i), P::Load(y + i), acc0);
+    acc1 = P::Fmadd(P::Load(x + i + kW), P::Load(y + i + kW), acc1);
+  }
+  for (; i < kVectorsEnd; i += kW) {
+    acc0 = P::Fmadd(P::Load(x + i), P::Load(y + i), acc0);
+  }
+  double sum = P::ReduceAdd(P::Add(acc0, acc1));
+  for (; i < N; ++i) {
+    sum += x[i] * y[i];
+  }
+  return sum;
+}
+
+// Errors of the previous layer of a static layer, before the derivative:
+// one dot product of constant length per row.
+template <typename P, std::size_t In, std::size_t Out>
+void StaticBackwardKernel(const double *weights, const double *errors,
+                          double *sums) {
+  for (std::size_t i = 0; i < In; ++i) {
+    sums[i] = StaticDotKernel<P, Out>(weights + i * Out, errors);
+  }
+}
+
+template <typename P, std::size_t In, std::size_t Out>
+void StaticUpdateKernel(const double *input, const double *errors, double lr,
+                        double *weights, double *biases) {
+  for (std::size_t i = 0; i < In; ++i) {
+    const double x = -lr * input[i];
+    if (x == 0.0) continue;
+    StaticAxpyKernel<P, Out>(x, errors, weights + i * Out);
+  }
+  for (std::size_t j = 0; j < Out; ++j) {
+    biases[j] -= lr * errors[j];
+  }
+}
+
+// Kernels of every shape of StaticLayerShapes; a plain array member keeps
+// the table free of library code compiled with the flags of the unit.
+struct StaticKernelTable {
+  StaticLayerKernels layers[kStaticLayerShapes];
+};
+
+template <typename P, std::size_t... I>
+constexpr StaticKernelTable MakeStaticKernels(std::index_sequence<I...>) {
+  return {{{StaticForwardKernel<
+                P, std::tuple_element_t<I, StaticLayerShapes>::kIn,
+                std::tuple_element_t<I, StaticLayerShapes>::kOut>,
+            StaticBackwardKernel<
+                P, std::tuple_element_t<I, StaticLayerShapes>::kIn,
+                std::tuple_element_t<I, StaticLayerShapes>::kOut>,
+            StaticUpdateKernel<
+                P, std::tuple_element_t<I, StaticLayerShapes>::kIn,
+                std::tuple_element_t<I, StaticLayerShapes>::kOut>}...}};
+}
+
+template <typename P>
+constexpr StaticKernelTable MakeStaticKernels() {
+  return MakeStaticKernels<P>(std::make_index_sequence<kStaticLayerShapes>{});
+}
+
+}  // namespace
+}  // namespace s21
+
+#endif  // MLP_MODEL_UTILITY_SIMD_KERNELS_H_
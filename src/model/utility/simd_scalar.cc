@@ -0,0 +1,37 @@
+#include "simd_kernels.h"
+
+namespace s21 {
+
+namespace {
+
+std::int32_t DotU8S8Kernel(const std::uint8_t *a, const std::int8_t *b,
+                           std::size_t n) {
+  return DotU8S8Tail(a, b, 0, n);
+}
+
+constexpr BasicSimdKernels<double> kScalarKernels =
+    MakeKernels<ScalarPack<double>, 4, 8>(SimdLevel::kScalar,
+                                           DotU8S8Kernel);
+constexpr BasicSimdKernels<float> kScalarFloatKernels =
+    MakeKernels<ScalarPack<float>, 4, 8>(SimdLevel::kScalar,
+                                          DotU8S8Kernel);
+constexpr StaticKernelTable kScalarStaticKernels =
+    MakeStaticKernels<ScalarPack<double>>();
+
+}  // namespace
+
+template <>
+const BasicSimdKernels<double> *GetScalarKernels() {
+  return &kScalarKernels;
+}
+
+template <>
+const BasicSimdKernels<float> *GetScalarKernels() {
+  return &kScalarFloatKernels;
+}
+
+const StaticLayerKernels *GetScalarStaticKernels() {
+  return kScalarStaticKernels.layers;
+}
+
+}  // namespace s21
@@ -0,0 +1,143 @@
+#include "simd.h"
+#include "static_kernels.h"
+
+#ifdef __SSE4_2__
+
+#include <immintrin.h>
+
+#include "simd_kernels.h"
+
+namespace s21 {
+
+namespace {
+
+struct Sse42Pack {
+  using Scalar = double;
+  using Reg = __m128d;
+  static constexpr std::size_t kWidth = 2;
+
+  static Reg Load(const double *p) { return _mm_loadu_pd(p); }
+  static void Store(double *p, Reg v) { _mm_storeu_pd(p, v); }
+  static Reg Set1(double x) { return _mm_set1_pd(x); }
+  static Reg Zero() { return _mm_setzero_pd(); }
+  static Reg Add(Reg a, Reg b) { return _mm_add_pd(a, b); }
+  static Reg Sub(Reg a, Reg b) { return _mm_sub_pd(a, b); }
+  static Reg Mul(Reg a, Reg b) { return _mm_mul_pd(a, b); }
+  static Reg Fmadd(Reg a, Reg b, Reg c) {
+    return _mm_add_pd(_mm_mul_pd(a, b), c);
+  }
+  static Reg Div(Reg a, Reg b) { return _mm_div_pd(a, b); }
+  static Reg Max(Reg a, Reg b) { return _mm_max_pd(a, b); }
+  static Reg Min(Reg a, Reg b) { return _mm_min_pd(a, b); }
+  static Reg Sqrt(Reg a) { return _mm_sqrt_pd(a); }
+  static Reg Round(Reg a) {
+    return _mm_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  }
+  static Reg Pow2(Reg n) {
+    const __m128i biased = _mm_castpd_si128(_mm_add_pd(n, Set1(kPow2Bias)));
+    return _mm_castsi128_pd(_mm_slli_epi64(biased, 52));
+  }
+  static Reg Step(Reg a) {
+    return _mm_and_pd(_mm_cmpgt_pd(a, Zero()), Set1(1.0));
+  }
+  static double ReduceAdd(Reg a) {
+    return _mm_cvtsd_f64(_mm_add_sd(a, _mm_unpackhi_pd(a, a)));
+  }
+};
+
+struct Sse42FloatPack {
+  using Scalar = float;
+  using Reg = __m128;
+  static constexpr std::size_t kWidth = 4;
+
+  static Reg Load(const float *p) { return _mm_loadu_ps(p); }
+  static void Store(float *p, Reg v) { _mm_storeu_ps(p, v); }
+  static Reg Set1(float x) { return _mm_set1_ps(x); }
+  static Reg Zero() { return _mm_setzero_ps(); }
+  static Reg Add(Reg a, Reg b) { return _mm_add_ps(a, b); }
+  static Reg Sub(Reg a, Reg b) { return _mm_sub_ps(a, b); }
+  static Reg Mul(Reg a, Reg b) { return _mm_mul_ps(a, b); }
+  static Reg Fmadd(Reg a, Reg b, Reg c) {
+    return _mm_add_ps(_mm_mul_ps(a, b), c);
+  }
+  static Reg Div(Reg a, Reg b) { return _mm_div_ps(a, b); }
+  static Reg Max(Reg a, Reg b) { return _mm_max_ps(a, b); }
+  static Reg Min(Reg a, Reg b) { return _mm_min_ps(a, b); }
+  static Reg Sqrt(Reg a) { return _mm_sqrt_ps(a); }
+  static Reg Round(Reg a) {
+    return _mm_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  }
+  static Reg Pow2(Reg n) {
+    const __m128i biased = _mm_castps_si128(_mm_add_ps(n, Set1(kPow2BiasF)));
+    return _mm_castsi128_ps(_mm_slli_epi32(biased, 23));
+  }
+  static Reg Step(Reg a) {
+    return _mm_and_ps(_mm_cmpgt_ps(a, Zero()), Set1(1.0f));
+  }
+  static float ReduceAdd(Reg a) {
+    __m128 sum = _mm_add_ps(a, _mm_movehl_ps(a, a));
+    return _mm_cvtss_f32(_mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1)));
+  }
+};
+
+// maddubs multiplies unsigned by signed bytes and adds adjacent pairs into
+// 16-bit lanes, madd with ones widens the pairs to 32-bit sums.
+std::int32_t Sse42DotU8S8(const std::uint8_t *a, const std::int8_t *b,
+                          std::size_t n) {
+  const __m128i ones = _mm_set1_epi16(1);
+  __m128i acc = _mm_setzero_si128();
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+    __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+    acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_maddubs_epi16(va, vb), ones));
+  }
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0x4e));
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0xb1));
+  return _mm_cvtsi128_si32(acc) + DotU8S8Tail(a, b, i, n);
+}
+
+constexpr BasicSimdKernels<double> kSse42Kernels =
+    MakeKernels<Sse42Pack, 4, 4>(SimdLevel::kSse42, Sse42DotU8S8);
+constexpr BasicSimdKernels<float> kSse42FloatKernels =
+    MakeKernels<Sse42FloatPack, 4, 8>(SimdLevel::kSse42, Sse42DotU8S8);
+constexpr StaticKernelTable kSse42StaticKernels =
+    MakeStaticKernels<Sse42Pack>();
+
+}  // namespace
+
+template <>
+const BasicSimdKernels<double> *GetSse42Kernels() {
+  return &kSse42Kernels;
+}
+
+template <>
+const BasicSimdKernels<float> *GetSse42Kernels() {
+  return &kSse42FloatKernels;
+}
+
+const StaticLayerKernels *GetSse42StaticKernels() {
+  return kSse42StaticKernels.layers;
+}
+
+}  // namespace s21
+
+#else
+
+namespace s21 {
+
+template <>
+const BasicSimdKernels<double> *GetSse42Kernels() {
+  return nullptr;
+}
+
+template <>
+const BasicSimdKernels<float> *GetSse42Kernels() {
+  return nullptr;
+}
+
+const StaticLayerKernels *GetSse42StaticKernels() { return nullptr; }
+
+}  // namespace s21
+
+#endif  // __SSE4_2__
@@ -0,0 +1,78 @@
+#ifndef MLP_MODEL_UTILITY_STATIC_KERNELS_H_
+#define MLP_MODEL_UTILITY_STATIC_KERNELS_H_
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+#include "simd.h"
+
+namespace s21 {
+
+/**
+ * @struct LayerShape
+ * @brief Number of inputs and of neurons of a fully connected layer, as
+ * compile-time constants.
+ */
+template <std::size_t In, std::size_t Out>
+struct LayerShape {
+  static constexpr std::size_t kIn = In;
+  static constexpr std::size_t kOut = Out;
+};
+
+// Layers of the static models compiled into the library, see static_mlp.h.
+// Every instruction set unit compiles the kernels of these shapes.
+using StaticLayerShapes =
+    std::tuple<LayerShape<784, 100>, LayerShape<100, 100>,
+               LayerShape<100, 26>, LayerShape<784, 128>,
+               LayerShape<128, 256>, LayerShape<256, 128>,
+               LayerShape<128, 26>>;
+constexpr std::size_t kStaticLayerShapes =
+    std::tuple_size_v<StaticLayerShapes>;
+
+/**
+ * @struct StaticLayerKernels
+ * @brief Kernels of one layer shape of a static model, with the weights
+ * stored as an In x Out row-major matrix. The sizes are constants of the
+ * kernels, so their loops are unrolled and the columns of the forward pass
+ * stay in registers across all the inputs.
+ */
+struct StaticLayerKernels {
+  // values = biases + input * weights
+  void (*forward)(const double *input, const double *weights,
+                  const double *biases, double *values);
+  // sums[i] = the dot product of row i of the weights with the errors.
+  void (*backward)(const double *weights, const double *errors,
+                   double *sums);
+  // weights -= lr * input^T * errors and biases -= lr * errors; the rows of
+  // zero inputs are skipped.
+  void (*update)(const double *input, const double *errors, double lr,
+                 double *weights, double *biases);
+};
+
+// Kernels of the shapes of StaticLayerShapes, in order, for an instruction
+// set; nullptr when it is not compiled in.
+const StaticLayerKernels *GetScalarStaticKernels();
+const StaticLayerKernels *GetSse42StaticKernels();
+const StaticLayerKernels *GetAvx2StaticKernels();
+const StaticLayerKernels *GetAvx512StaticKernels();
+// Kernels of the instruction set currently in use.
+const StaticLayerKernels *GetStaticKernels();
+
+// Index of a shape in StaticLayerShapes, kStaticLayerShapes if absent.
+template <std::size_t In, std::size_t Out, std::size_t I = 0>
+constexpr std::size_t StaticShapeIndex() {
+  if constexpr (I == kStaticLayerShapes) {
+    return I;
+  } else if constexpr (std::is_same_v<
+                           std::tuple_element_t<I, StaticLayerShapes>,
+                           LayerShape<In, Out>>) {
+    return I;
+  } else {
+    return StaticShapeIndex<In, Out, I + 1>();
+  }
+}
+
+}  // namespace s21
+
+#endif  // MLP_MODEL_UTILITY_STATIC_KERNELS_H_
@@ -2,21 +2,276 @@
 #define MLP_MODEL_UTILITY_THREAD_POOL_H_
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
 #include <future>
 #include <iterator>
+#include <memory>
+#include <mutex>
 #include <queue>
 #include <random>
+#include <stdexcept>
 #include <thread>
 #include <vector>
 
 namespace s21 {
 
+/**
+ * @class ThreadPool
+ * @brief Fixed set of persistent worker threads.
+ *
+ * Besides running queued tasks, the pool executes parallel loops: the
+ * iterations are handed out one at a time from a shared atomic counter, so
+ * uneven iterations are balanced dynamically, and the calling thread works
+ * on the loop too. A parallel loop started from inside another one, or from
+ * a task of the pool, runs serially on the calling thread, so nested
+ * parallel code never waits on workers that are busy with the outer loop.
+ */
 class ThreadPool {
  public:
   explicit ThreadPool(std::size_t num_threads) : stop_{false} {
+    Start(num_threads);
+  }
+
+  ~ThreadPool() { Stop(); }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  std::size_t GetThreadsCount() const { return threads_.size(); }
+
+  // Replaces the workers; must not be called while the pool is in use.
+  void Resize(std::size_t num_threads) {
+    Stop();
+    stop_ = false;
+    Start(num_threads);
+  }
+
+  template <typename F, typename... Args>
+  auto enqueue(F &&f, Args &&...args)
+      -> std::future<typename std::result_of<F(Args...)>::type> {
+    using return_type = typename std::result_of<F(Args...)>::type;
+    auto task = std::make_shared<std::packaged_task<return_type()>>(
+        std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+    auto result = task->get_future();
+    {
+      std::unique_lock<std::mutex> lock{mtx_};
+      if (stop_) throw std::runtime_error("enqueue on stopped ThreadPool");
+      auto new_task = [task]() { (*task)(); };
+      queue_.emplace(std::move(new_task));
+    }
+    cv_.notify_one();
+    return result;
+  }
+
+  /**
+   * Calls body(i) for every i in [0, count) and returns when all calls have
+   * finished. The first exception thrown by body is rethrown here.
+   */
+  template <typename F>
+  void ParallelFor(std::size_t count, F &&body) {
+    if (count == 0) return;
+    if (count == 1 or threads_.empty() or InParallelRegion()) {
+      for (std::size_t i = 0; i < count; ++i) body(i);
+      return;
+    }
+    using Body = std::remove_reference_t<F>;
+    auto state = std::make_shared<LoopState>();
+    state->count = count;
+    state->body = std::addressof(body);
+    state->invoke = [](const void *f, std::size_t i) {
+      (*static_cast<Body *>(const_cast<void *>(f)))(i);
+    };
+    const std::size_t helpers = std::min(threads_.size(), count - 1);
+    {
+      std::unique_lock<std::mutex> lock{mtx_};
+      for (std::size_t i = 0; i < helpers; ++i) {
+        queue_.emplace([state]() { RunIterations(*state); });
+      }
+    }
+    cv_.notify_all();
+
+    InParallelRegion() = true;
+    RunIterations(*state);
+    InParallelRegion() = false;
+    {
+      std::unique_lock<std::mutex> lock{state->mtx};
+      state->cv.wait(lock, [&state, count]() {
+        return state->done.load(std::memory_order_acquire) == count;
+      });
+    }
+    if (state->error) std::rethrow_exception(state->error);
+  }
+
+  /**
+   * Splits [0, count) into ranges of at most grain iterations and calls
+   * body(begin, end) for each of them in parallel.
+   */
+  template <typename F>
+  void ParallelForRange(std::size_t count, std::size_t grain, F &&body) {
+    grain = std::max<std::size_t>(grain, 1);
+    ParallelFor((count + grain - 1) / grain, [&](std::size_t block) {
+      const std::size_t begin = block * grain;
+      body(begin, std::min(begin + grain, count));
+    });
+  }
+
+  /**
+   * Splits a rows x cols iteration space into tiles of at most tile_rows x
+   * tile_cols and calls body(row_begin, row_end, col_begin, col_end) for
+   * each of them in parallel. Tiles are scheduled dynamically in row-major
+   * order.
+   */
+  template <typename F>
+  void ParallelFor2D(std::size_t rows, std::size_t cols, std::size_t tile_rows,
+                     std::size_t tile_cols, F &&body) {
+    tile_rows = std::max<std::size_t>(tile_rows, 1);
+    tile_cols = std::max<std::size_t>(tile_cols, 1);
+    const std::size_t row_tiles = (rows + tile_rows - 1) / tile_rows;
+    const std::size_t col_tiles = (cols + tile_cols - 1) / tile_cols;
+    ParallelFor(row_tiles * col_tiles, [&](std::size_t tile) {
+      const std::size_t row = tile / col_tiles * tile_rows;
+      const std::size_t col = tile % col_tiles * tile_cols;
+      body(row, std::min(row + tile_rows, rows), col,
+           std::min(col + tile_cols, cols));
+    });
+  }
+
+  /**
+   * Calls body(node) for every node of a directed acyclic graph, given as
+   * the successors of each node, a node only once all its predecessors have
+   * finished. Every node counts its unfinished predecessors; the nodes whose
+   * count drops to zero are queued and taken by the first free thread, so
+   * independent nodes run in parallel. The first exception thrown by body
+   * stops the scheduling and is rethrown here.
+   *
+   * @throws std::invalid_argument If the graph has a cycle or a successor
+   * out of range.
+   */
+  template <typename F>
+  void ParallelForGraph(const std::vector<std::vector<std::size_t>> &successors,
+                        F &&body) {
+    const std::size_t count = successors.size();
+    std::vector<std::size_t> pending(count, 0);
+    for (const auto &next : successors) {
+      for (std::size_t node : next) {
+        if (node >= count) {
+          throw std::invalid_argument("Graph successor out of range");
+        }
+        ++pending[node];
+      }
+    }
+    std::vector<std::size_t> ready;
+    for (std::size_t node = 0; node < count; ++node) {
+      if (pending[node] == 0) ready.push_back(node);
+    }
+    CheckAcyclic(successors, pending, ready);
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::size_t finished = 0;
+    bool failed = false;
+    const auto work = [&](std::size_t) {
+      for (;;) {
+        std::size_t node;
+        {
+          std::unique_lock<std::mutex> lock{mtx};
+          cv.wait(lock, [&]() {
+            return failed or finished == count or not ready.empty();
+          });
+          if (failed or finished == count) return;
+          node = ready.back();
+          ready.pop_back();
+        }
+        try {
+          body(node);
+        } catch (...) {
+          {
+            std::lock_guard<std::mutex> lock{mtx};
+            failed = true;
+          }
+          cv.notify_all();
+          throw;
+        }
+        {
+          std::lock_guard<std::mutex> lock{mtx};
+          for (std::size_t next : successors[node]) {
+            if (--pending[next] == 0) ready.push_back(next);
+          }
+          ++finished;
+        }
+        cv.notify_all();
+      }
+    };
+    ParallelFor(std::min(threads_.size() + 1, count), work);
+  }
+
+ private:
+  using Task = std::function<void()>;
+
+  // Runs Kahn's algorithm on copies of the counts to reject the graphs whose
+  // nodes would never become ready.
+  static void CheckAcyclic(
+      const std::vector<std::vector<std::size_t>> &successors,
+      std::vector<std::size_t> pending, std::vector<std::size_t> ready) {
+    std::size_t visited = 0;
+    while (not ready.empty()) {
+      const std::size_t node = ready.back();
+      ready.pop_back();
+      ++visited;
+      for (std::size_t next : successors[node]) {
+        if (--pending[next] == 0) ready.push_back(next);
+      }
+    }
+    if (visited != successors.size()) {
+      throw std::invalid_argument("Graph has a cycle");
+    }
+  }
+
+  // Shared by the threads running one parallel loop. Helpers that are
+  // dequeued after the loop has finished find no iterations left and never
+  // touch the body, which lives on the stack of the calling thread.
+  struct LoopState {
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> done{0};
+    std::size_t count = 0;
+    const void *body = nullptr;
+    void (*invoke)(const void *, std::size_t) = nullptr;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::exception_ptr error;
+  };
+
+  static bool &InParallelRegion() {
+    thread_local bool inside = false;
+    return inside;
+  }
+
+  static void RunIterations(LoopState &state) {
+    for (;;) {
+      const std::size_t i = state.next.fetch_add(1, std::memory_order_relaxed);
+      if (i >= state.count) return;
+      try {
+        state.invoke(state.body, i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock{state.mtx};
+        if (not state.error) state.error = std::current_exception();
+      }
+      if (state.done.fetch_add(1, std::memory_order_acq_rel) + 1 ==
+          state.count) {
+        std::lock_guard<std::mutex> lock{state.mtx};
+        state.cv.notify_all();
+      }
+    }
+  }
+
+  void Start(std::size_t num_threads) {
     for (std::size_t i = 0; i < num_threads; ++i) {
       threads_.emplace_back([this]() {
-        while (!stop_) {
+        InParallelRegion() = true;
+        for (;;) {
           Task task;
           {
             std::unique_lock<std::mutex> lock{mtx_};
@@ -31,43 +286,36 @@ class ThreadPool {
     }
   }
 
-  ~ThreadPool() {
+  void Stop() {
     {
       std::unique_lock<std::mutex> lock{mtx_};
       stop_ = true;
     }
     cv_.notify_all();
-    for (auto& thread : threads_) {
+    for (auto &thread : threads_) {
       thread.join();
     }
+    threads_.clear();
   }
 
-  template <typename F, typename... Args>
-  auto enqueue(F&& f, Args&&... args)
-      -> std::future<typename std::result_of<F(Args...)>::type> {
-    using return_type = typename std::result_of<F(Args...)>::type;
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
-        std::bind(std::forward<F>(f), std::forward<Args>(args)...));
-    auto result = task->get_future();
-    {
-      std::unique_lock<std::mutex> lock{mtx_};
-      if (stop_) throw std::runtime_error("enqueue on stopped ThreadPool");
-      auto new_task = [task]() { (*task)(); };
-      queue_.emplace(std::move(new_task));
-    }
-    cv_.notify_one();
-    return result;
-  }
-
- private:
-  using Task = std::function<void()>;
-
   std::vector<std::thread> threads_;
   std::queue<Task> queue_;
   std::mutex mtx_;
   std::condition_variable cv_;
   bool stop_;
 };
+
+/**
+ * Returns the pool shared by the parallel kernels. It has one worker less
+ * than the hardware threads, since the calling thread takes part in every
+ * parallel loop.
+ */
+inline ThreadPool &GetThreadPool() {
+  static ThreadPool pool(
+      std::max<std::size_t>(std::thread::hardware_concurrency(), 1) - 1);
+  return pool;
+}
+
 }  // namespace s21
 
 #endif  // MLP_MODEL_UTILITY_THREAD_POOL_H_
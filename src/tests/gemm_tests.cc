@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "gemm.h"
+#include "matrix_operations.h"
+
+using namespace s21;
+
+namespace {
+
+constexpr double kEps = 1e-9;
+
+Matrix ReferenceProduct(ConstMatrixView a, ConstMatrixView b) {
+  Matrix result(a.GetRows(), b.GetCols());
+  for (std::size_t i = 0; i < a.GetRows(); ++i) {
+    for (std::size_t j = 0; j < b.GetCols(); ++j) {
+      for (std::size_t k = 0; k < a.GetCols(); ++k) {
+        result(i, j) += a(i, k) * b(k, j);
+      }
+    }
+  }
+  return result;
+}
+
+void ExpectNear(const Matrix& m1, const Matrix& m2) {
+  ASSERT_EQ(m1.GetRows(), m2.GetRows());
+  ASSERT_EQ(m1.GetCols(), m2.GetCols());
+  for (std::size_t i = 0; i < m1.GetSize(); ++i) {
+    const double expected = m2.Data()[i];
+    ASSERT_NEAR(m1.Data()[i], expected, kEps * (1.0 + std::fabs(expected)));
+  }
+}
+
+Matrix RandomMatrix(std::size_t rows, std::size_t cols) {
+  Matrix matrix(rows, cols);
+  RandomizeMatrix(matrix);
+  return matrix;
+}
+
+}  // namespace
+
+TEST(Gemm, Sizes) {
+  const std::size_t sizes[][3] = {{1, 1, 1},     {1, 784, 100}, {3, 17, 5},
+                                  {4, 8, 8},     {5, 9, 13},    {37, 300, 41},
+                                  {130, 260, 9}, {64, 513, 70}};
+  for (const auto& size : sizes) {
+    Matrix a = RandomMatrix(size[0], size[1]);
+    Matrix b = RandomMatrix(size[1], size[2]);
+    Matrix c(size[0], size[2]);
+    Gemm(a, b, c);
+    ExpectNear(c, ReferenceProduct(a, b));
+  }
+}
+
+TEST(Gemm, AlphaBeta) {
+  Matrix a = RandomMatrix(19, 23);
+  Matrix b = RandomMatrix(23, 11);
+  Matrix c = RandomMatrix(19, 11);
+  Matrix expected = ReferenceProduct(a, b);
+  for (std::size_t i = 0; i < expected.GetSize(); ++i) {
+    expected.Data()[i] = -0.5 * expected.Data()[i] + 2.0 * c.Data()[i];
+  }
+  Gemm(a, b, c, -0.5, 2.0);
+  ExpectNear(c, expected);
+}
+
+TEST(Gemm, TransposedViews) {
+  Matrix a = RandomMatrix(300, 7);
+  Matrix b = RandomMatrix(9, 300);
+  Matrix c(7, 9);
+  Gemm(a.GetView().Transposed(), b.GetView().Transposed(), c);
+  ExpectNear(c, ReferenceProduct(a.GetView().Transposed(),
+                                 b.GetView().Transposed()));
+
+  Matrix row = RandomMatrix(1, 300);
+  Matrix out(1, 9);
+  Gemm(row, b.GetView().Transposed(), out);
+  ExpectNear(out, ReferenceProduct(row, b.GetView().Transposed()));
+}
+
+TEST(Gemm, Blocks) {
+  Matrix a = RandomMatrix(20, 20);
+  Matrix b = RandomMatrix(20, 20);
+  Matrix c(20, 20);
+  Gemm(a.GetView().Block(2, 3, 10, 12), b.GetView().Block(1, 4, 12, 6),
+       c.GetView().Block(5, 5, 10, 6));
+  Matrix expected = ReferenceProduct(a.GetView().Block(2, 3, 10, 12),
+                                     b.GetView().Block(1, 4, 12, 6));
+  ExpectNear(Matrix(c.GetView().Block(5, 5, 10, 6)), expected);
+  EXPECT_DOUBLE_EQ(c(0, 0), 0.0);
+  EXPECT_DOUBLE_EQ(c(15, 11), 0.0);
+}
+
+TEST(Gemm, BiasActivate) {
+  const std::size_t sizes[][3] = {
+      {1, 784, 100}, {3, 17, 5}, {37, 300, 41}, {130, 260, 9}};
+  for (const auto& size : sizes) {
+    Matrix a = RandomMatrix(size[0], size[1]);
+    Matrix b = RandomMatrix(size[1], size[2]);
+    Matrix bias = RandomMatrix(1, size[2]);
+    for (activation_func func : {sigmoid, relu, s21::tanh}) {
+      Matrix expected = ReferenceProduct(a, b);
+      for (std::size_t i = 0; i < expected.GetRows(); ++i) {
+        for (std::size_t j = 0; j < expected.GetCols(); ++j) {
+          expected(i, j) = func(expected(i, j) + bias(0, j));
+        }
+      }
+      Matrix c;
+      ActivateLayer(a, b, bias, func, c);
+      ExpectNear(c, expected);
+    }
+  }
+
+  Matrix a = RandomMatrix(300, 2);
+  Matrix b = RandomMatrix(300, 7);
+  Matrix bias = RandomMatrix(1, 7);
+  Matrix c(2, 7);
+  GemmBiasActivate(a.GetView().Transposed(), b, bias, c, nullptr);
+  Matrix expected = ReferenceProduct(a.GetView().Transposed(), b);
+  for (std::size_t i = 0; i < expected.GetRows(); ++i) {
+    for (std::size_t j = 0; j < expected.GetCols(); ++j) {
+      expected(i, j) += bias(0, j);
+    }
+  }
+  ExpectNear(c, expected);
+}
+
+TEST(Gemm, Parallel) {
+  Matrix a = RandomMatrix(300, 270);
+  Matrix b = RandomMatrix(270, 600);
+  Matrix bias = RandomMatrix(1, 600);
+  Matrix c(300, 600), fused(300, 600);
+  const std::size_t threads = GetThreadPool().GetThreadsCount();
+  GetThreadPool().Resize(3);
+  Gemm(a, b.GetView(), c);
+  GemmBiasActivate(a, b, bias, fused, GetSimdKernels().relu);
+  GetThreadPool().Resize(threads);
+  Matrix expected = ReferenceProduct(a, b);
+  ExpectNear(c, expected);
+  for (std::size_t i = 0; i < expected.GetRows(); ++i) {
+    for (std::size_t j = 0; j < expected.GetCols(); ++j) {
+      expected(i, j) = relu(expected(i, j) + bias(0, j));
+    }
+  }
+  ExpectNear(fused, expected);
+}
+
+TEST(Gemm, Float) {
+  const std::size_t sizes[][3] = {
+      {2, 9, 5}, {7, 33, 45}, {64, 300, 70}, {130, 260, 600}};
+  for (const auto& size : sizes) {
+    Matrix a = RandomMatrix(size[0], size[1]);
+    Matrix b = RandomMatrix(size[1], size[2]);
+    Matrix bias = RandomMatrix(1, size[2]);
+    FloatMatrix c(size[0], size[2]), fused;
+    Gemm(FloatMatrix(a), FloatMatrix(b), c);
+    ActivateLayer(FloatMatrix(a), FloatMatrix(b), FloatMatrix(bias), sigmoid,
+                  fused);
+    Matrix expected = ReferenceProduct(a, b);
+    for (std::size_t i = 0; i < c.GetSize(); ++i) {
+      const double value = expected.Data()[i];
+      ASSERT_NEAR(c.Data()[i], value, 1e-5 * size[1]);
+      const double activated = sigmoid(value + bias(0, i % size[2]));
+      ASSERT_NEAR(fused.Data()[i], activated, 1e-5 * size[1]);
+    }
+  }
+}
+
+TEST(Gemm, Exceptions) {
+  Matrix a(2, 3), b(4, 2), c(2, 2);
+  EXPECT_THROW(Gemm(a, b, c), std::logic_error);
+  Matrix bias(1, 3);
+  EXPECT_THROW(GemmBiasActivate(a, Matrix(3, 2), bias, c, nullptr),
+               std::logic_error);
+}
@@ -0,0 +1,248 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "graph_mlp.h"
+#include "matrix_mlp.h"
+
+using namespace s21;
+
+namespace {
+
+// Two branches of the input joined by a layer, then an output layer that
+// also takes the input through a skip connection.
+const std::vector<GraphNode> kBranches{{5, {}, Activation::kSigmoid},
+                                       {4, {0}, Activation::kTanh},
+                                       {3, {0}, Activation::kSigmoid},
+                                       {4, {1, 2}, Activation::kSigmoid},
+                                       {3, {3, 0}, Activation::kSigmoid}};
+
+// Output of a graph computed directly from its weights.
+Vector Forward(const std::vector<GraphNode> &nodes, const Tensor &weights,
+               const Tensor &biases, const Vector &input) {
+  std::vector<Vector> values(nodes.size());
+  values[0] = input;
+  for (std::size_t k = 1; k < nodes.size(); ++k) {
+    Vector in;
+    for (std::size_t i : nodes[k].inputs) {
+      in.insert(in.end(), values[i].begin(), values[i].end());
+    }
+    values[k].resize(nodes[k].size);
+    for (std::size_t j = 0; j < nodes[k].size; ++j) {
+      double sum = biases[k - 1](0, j);
+      for (std::size_t r = 0; r < in.size(); ++r) {
+        sum += in[r] * weights[k - 1](r, j);
+      }
+      values[k][j] = ApplyActivation(sum, nodes[k].activation);
+    }
+  }
+  return values.back();
+}
+
+// The loss minimised by the back-propagation.
+double Loss(GraphMlp &mlp, const Vector &input, const Vector &expected) {
+  mlp.SetInputLayer(input);
+  mlp.ForwardPropagation();
+  const Vector output = mlp.GetOutput();
+  double loss = 0.0;
+  for (std::size_t i = 0; i < output.size(); ++i) {
+    loss += 0.5 * (expected[i] - output[i]) * (expected[i] - output[i]);
+  }
+  return loss;
+}
+
+// Trains a chain GraphMlp and a MatrixMlp with the same weights on the same
+// samples, which must give the same outputs and weights at every step.
+void ExpectMatchesMatrixMlp(const Topology &topology, int steps) {
+  GraphMlp graph(topology);
+  MatrixMlp matrix(topology);
+  const auto [weights, biases] = graph.GetMlp();
+  matrix.SetMlp(weights, biases);
+
+  Vector input(topology.GetInputSize());
+  for (int step = 0; step < steps; ++step) {
+    RandomizeVector(input);
+    Vector expected(topology.GetOutputSize(), 0.0);
+    expected[step % expected.size()] = 1.0;
+    for (AbstractMlp *mlp : {static_cast<AbstractMlp *>(&graph),
+                             static_cast<AbstractMlp *>(&matrix)}) {
+      mlp->SetInputLayer(input);
+      mlp->ForwardPropagation();
+    }
+    const Vector output = graph.GetOutput(), reference = matrix.GetOutput();
+    for (std::size_t i = 0; i < output.size(); ++i) {
+      EXPECT_NEAR(output[i], reference[i], 1e-12);
+    }
+    graph.BackPropagation(expected, 0.5);
+    matrix.BackPropagation(expected, 0.5);
+
+    const auto [graph_weights, graph_biases] = graph.GetMlp();
+    const auto [matrix_weights, matrix_biases] = matrix.GetMlp();
+    for (std::size_t l = 0; l < graph_weights.size(); ++l) {
+      for (std::size_t i = 0; i < graph_weights[l].GetSize(); ++i) {
+        EXPECT_NEAR(graph_weights[l].begin()[i],
+                    matrix_weights[l].begin()[i], 1e-12);
+      }
+      for (std::size_t i = 0; i < graph_biases[l].GetSize(); ++i) {
+        EXPECT_NEAR(graph_biases[l].begin()[i], matrix_biases[l].begin()[i],
+                    1e-12);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST(GraphMlp, MatchesMatrixMlp) {
+  SeedRandomWeights(4);
+  ExpectMatchesMatrixMlp(Topology{6, 5, 4, 3}, 1);
+}
+
+TEST(GraphMlp, ErrorSumsMatchMatrixMlp) {
+  // The errors of the first layers are summed through every layer above,
+  // wider and narrower ones, and through the derivatives of each activation.
+  SeedRandomWeights(6);
+  Topology topology{12, 20, 9, 16, 5};
+  topology.SetActivation(Activation::kTanh, 1);
+  topology.SetActivation(Activation::kRelu, 2);
+  ExpectMatchesMatrixMlp(topology, 8);
+}
+
+TEST(GraphMlp, ChainOfNodes) {
+  SeedRandomWeights(3);
+  GraphMlp chain(Topology{6, 5, 4, 3});
+  SeedRandomWeights(3);
+  GraphMlp graph({{6, {}}, {5, {0}}, {4, {1}}, {3, {2}}});
+
+  Vector input(6);
+  for (int step = 0; step < 5; ++step) {
+    RandomizeVector(input);
+    Vector expected(3, 0.0);
+    expected[step % 3] = 1.0;
+    for (GraphMlp *mlp : {&chain, &graph}) {
+      mlp->SetInputLayer(input);
+      mlp->ForwardPropagation();
+      mlp->BackPropagation(expected, 0.5);
+    }
+    EXPECT_EQ(chain.GetOutput(), graph.GetOutput());
+  }
+}
+
+TEST(GraphMlp, Branches) {
+  ThreadPool &pool = GetThreadPool();
+  const std::size_t threads = pool.GetThreadsCount();
+  pool.Resize(3);
+
+  GraphMlp mlp(kBranches);
+  const auto [weights, biases] = mlp.GetMlp();
+  ASSERT_EQ(weights.size(), 4);
+  EXPECT_EQ(weights[2].GetRows(), 7);
+  EXPECT_EQ(weights[3].GetRows(), 9);
+
+  Vector input(5);
+  RandomizeVector(input);
+  const Vector expected{0.0, 1.0, 0.0};
+  mlp.SetInputLayer(input);
+  mlp.ForwardPropagation();
+  const Vector output = mlp.GetOutput();
+  const Vector reference = Forward(kBranches, weights, biases, input);
+  for (std::size_t i = 0; i < output.size(); ++i) {
+    EXPECT_NEAR(output[i], reference[i], 1e-12);
+  }
+
+  // One step moves every weight against the gradient of the loss, which is
+  // checked by central differences.
+  const double lr = 1e-3, h = 1e-6;
+  mlp.BackPropagation(expected, lr);
+  const auto [trained, trained_biases] = mlp.GetMlp();
+  for (std::size_t l = 0; l < weights.size(); ++l) {
+    for (bool bias : {false, true}) {
+      Tensor w = weights, b = biases;
+      Matrix &params = bias ? b[l] : w[l];
+      const Matrix &moved = bias ? trained_biases[l] : trained[l];
+      for (std::size_t i = 0; i < params.GetSize(); ++i) {
+        const double original = params.begin()[i];
+        params.begin()[i] = original + h;
+        mlp.SetMlp(w, b);
+        const double plus = Loss(mlp, input, expected);
+        params.begin()[i] = original - h;
+        mlp.SetMlp(w, b);
+        const double minus = Loss(mlp, input, expected);
+        params.begin()[i] = original;
+        const double gradient = (plus - minus) / (2 * h);
+        EXPECT_NEAR((moved.begin()[i] - original) / lr, -gradient, 1e-6);
+      }
+    }
+  }
+  EXPECT_EQ(mlp.GetNodes().size(), kBranches.size());
+
+  pool.Resize(threads);
+}
+
+TEST(GraphMlp, WideLayersMatchAcrossThreadCounts) {
+  ThreadPool &pool = GetThreadPool();
+  const std::size_t threads = pool.GetThreadsCount();
+  // Every node has its own depth, so the layers run in order and split their
+  // passes between the threads. The second layer feeds the third one and the
+  // output through a skip connection, so its errors are summed over two next
+  // layers at different columns.
+  const std::vector<GraphNode> nodes{
+      {256, {}}, {256, {0}}, {256, {1}}, {8, {2, 1}}};
+  Vector input(256);
+  RandomizeVector(input);
+  Vector expected(8, 0.0);
+  expected[3] = 1.0;
+
+  std::vector<Vector> outputs;
+  std::vector<Tensor> trained;
+  for (std::size_t count : {0, 3}) {
+    pool.Resize(count);
+    SeedRandomWeights(9);
+    GraphMlp mlp(nodes);
+    mlp.SetInputLayer(input);
+    mlp.ForwardPropagation();
+    outputs.push_back(mlp.GetOutput());
+    mlp.BackPropagation(expected, 0.5);
+    const auto [weights, biases] = mlp.GetMlp();
+    trained.push_back(weights);
+    trained.push_back(biases);
+  }
+  EXPECT_EQ(outputs[0], outputs[1]);
+  for (std::size_t l = 0; l < trained[0].size(); ++l) {
+    EXPECT_TRUE(std::equal(trained[0][l].begin(), trained[0][l].end(),
+                           trained[2][l].begin()));
+    EXPECT_TRUE(std::equal(trained[1][l].begin(), trained[1][l].end(),
+                           trained[3][l].begin()));
+  }
+
+  pool.Resize(threads);
+}
+
+TEST(GraphMlp, RejectsInvalidGraphs) {
+  using Nodes = std::vector<GraphNode>;
+  EXPECT_THROW(GraphMlp(Nodes{{4, {}}}), std::invalid_argument);
+  EXPECT_THROW(GraphMlp(Nodes{{4, {0}}, {3, {0}}}), std::invalid_argument);
+  EXPECT_THROW(GraphMlp(Nodes{{4, {}}, {3, {}}}), std::invalid_argument);
+  EXPECT_THROW(GraphMlp(Nodes{{4, {}}, {3, {1}}}), std::invalid_argument);
+  EXPECT_THROW(GraphMlp(Nodes{{4, {}}, {3, {0, 0}}}), std::invalid_argument);
+  EXPECT_THROW(GraphMlp(Nodes{{4, {}}, {0, {0}}}), std::invalid_argument);
+  EXPECT_THROW(GraphMlp(Nodes{{4, {}}, {3, {0}}, {2, {0}}}),
+               std::invalid_argument);
+}
+
+TEST(GraphMlp, LayerViews) {
+  GraphMlp mlp(kBranches);
+  const LayerViews views = mlp.GetLayerViews();
+  const auto &layers = std::get<std::vector<LayerView>>(views);
+  const auto [weights, biases] = mlp.GetMlp();
+  ASSERT_EQ(layers.size(), weights.size());
+  for (std::size_t l = 0; l < layers.size(); ++l) {
+    // The neurons store their weights as rows, viewed as columns.
+    EXPECT_FALSE(layers[l].weights.IsContiguous());
+    EXPECT_EQ(layers[l].weights.GetRowStride(), 1);
+    EXPECT_EQ(layers[l].weights.GetRows(), weights[l].GetRows());
+    EXPECT_EQ(layers[l].weights.GetCols(), weights[l].GetCols());
+    EXPECT_EQ(layers[l].weights(1, 2), weights[l](1, 2));
+    EXPECT_EQ(layers[l].biases(0, 1), biases[l](0, 1));
+  }
+}
@@ -0,0 +1,53 @@
+#include <iostream>
+
+#include "mlp.h"
+
+using namespace s21;
+
+namespace {
+
+constexpr char kWeights[] =
+    "weights/mlp_5layers_0.183609mse_0.796662acc_0.01lr.bin";
+constexpr char kTestDataset[] = "../datasets/emnist-letters-test.csv";
+
+// Tests the pretrained model on the EMNIST test set in both math modes and
+// reports the change of accuracy of the polynomial sigmoid.
+void Compare(MLP& mlp, const std::string& name) {
+  mlp.SetMathMode(MathMode::kExact);
+  mlp.Test();
+  const Metrics exact = mlp.GetMetrics();
+  mlp.SetMathMode(MathMode::kFast);
+  mlp.Test();
+  const Metrics fast = mlp.GetMetrics();
+  mlp.SetMathMode(MathMode::kExact);
+
+  std::cout << name << " model\n";
+  fast.AccuracyDeltaReport(exact, "Fast");
+  std::cout << "\n";
+}
+
+}  // namespace
+
+int main() {
+  system("clear");
+  std::cout << GetColor(Color::kMagenta) << Align("FAST MATH ACCURACY TEST")
+            << GetColor(Color::kEnd) << "\n\n";
+
+  MLP mlp{Topology{}};
+  mlp.SetMFunc([](Metrics) {});
+  mlp.SetPFunc([](int) {});
+  mlp.SetFPFunc([](double) {});
+  mlp.Load(kWeights);
+  mlp.SetTestDataset(kTestDataset);
+
+  Compare(mlp, "Double");
+  mlp.SetPrecision(Config::Precision::kFloat);
+  Compare(mlp, "Float");
+  mlp.SetType(Config::ModelType::kGraph);
+  mlp.Load(kWeights);
+  Compare(mlp, "Graph");
+
+  std::cout << GetColor(Color::kMagenta) << Align(" ") << GetColor(Color::kEnd)
+            << "\n\n";
+  return 0;
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include "matrix_operations.h"
+
+using namespace s21;
+
+namespace {
+
+constexpr double kEps = 1e-9;
+
+void ExpectNear(const Matrix& m1, const Matrix& m2) {
+  ASSERT_EQ(m1.GetRows(), m2.GetRows());
+  ASSERT_EQ(m1.GetCols(), m2.GetCols());
+  for (std::size_t i = 0; i < m1.GetSize(); ++i) {
+    ASSERT_NEAR(m1.Data()[i], m2.Data()[i], kEps);
+  }
+}
+
+Matrix RandomMatrix(std::size_t rows, std::size_t cols) {
+  Matrix matrix(rows, cols);
+  RandomizeMatrix(matrix);
+  return matrix;
+}
+
+}  // namespace
+
+TEST(MatrixExpression, ElementWise) {
+  Matrix a = RandomMatrix(7, 5), b = RandomMatrix(7, 5), c = RandomMatrix(7, 5);
+  Matrix m = a + b * 2.0 - MultiplyHadamard(c - a, b);
+  Matrix expected =
+      Subtraction(Addition(a, MultiplyNumber(b, 2.0)),
+                  MultiplyHadamard(Subtraction(c, a), b));
+  ExpectNear(m, expected);
+
+  m += a;
+  ExpectNear(m, Addition(expected, a));
+  m -= a * 3.0;
+  ExpectNear(m, Subtraction(Addition(expected, a), MultiplyNumber(a, 3.0)));
+}
+
+TEST(MatrixExpression, Products) {
+  Matrix a = RandomMatrix(9, 6), b = RandomMatrix(6, 11);
+  Matrix c = RandomMatrix(9, 11), d = RandomMatrix(11, 4);
+  ExpectNear(a * b, Multiplication(a, b));
+  ExpectNear(a * b * 0.5, MultiplyNumber(Multiplication(a, b), 0.5));
+  ExpectNear(a * b * d, Multiplication(Multiplication(a, b), d));
+  ExpectNear((a * b + c) * d,
+             Multiplication(Addition(Multiplication(a, b), c), d));
+  ExpectNear(MultiplyHadamard(a * b, c),
+             MultiplyHadamard(Multiplication(a, b), c));
+  ExpectNear(Transpose(a) * c, MultiplyTN(a, c));
+  ExpectNear(c * Transpose(b), MultiplyNT(c, b));
+
+  Matrix m = c;
+  m -= a * b * 0.25;
+  ExpectNear(m, Subtraction(c, MultiplyNumber(Multiplication(a, b), 0.25)));
+  Matrix before = m;
+  m += Transpose(Transpose(b) * Transpose(a)) * 2.0;
+  ExpectNear(m, Addition(before, MultiplyNumber(Multiplication(a, b), 2.0)));
+}
+
+TEST(MatrixExpression, Aliasing) {
+  Matrix a = RandomMatrix(5, 5), b = RandomMatrix(5, 5);
+  Matrix m = a;
+  m = Transpose(m);
+  ExpectNear(m, Matrix(a.GetView().Transposed()));
+  m = a;
+  m = m * b;
+  ExpectNear(m, Multiplication(a, b));
+  m = a;
+  m = m + Transpose(m);
+  ExpectNear(m, Addition(a, Matrix(a.GetView().Transposed())));
+  m = a;
+  m -= m * b;
+  ExpectNear(m, Subtraction(a, Multiplication(a, b)));
+  m = a;
+  m = MultiplyHadamard(m * b, m);
+  ExpectNear(m, MultiplyHadamard(Multiplication(a, b), a));
+}
+
+TEST(MatrixExpression, Float) {
+  Matrix a = RandomMatrix(9, 6), b = RandomMatrix(6, 11);
+  Matrix c = RandomMatrix(9, 11);
+  FloatMatrix fa(a), fb(b), fc(c);
+  FloatMatrix m = MultiplyHadamard(fa * fb - fc, fc) * 0.5;
+  m -= fa * fb * 2.0 + Transpose(Transpose(fc));
+  Matrix expected = MultiplyHadamard(a * b - c, c) * 0.5;
+  expected -= a * b * 2.0 + c;
+  ASSERT_EQ(m.GetRows(), expected.GetRows());
+  ASSERT_EQ(m.GetCols(), expected.GetCols());
+  for (std::size_t i = 0; i < m.GetSize(); ++i) {
+    ASSERT_NEAR(m.Data()[i], expected.Data()[i], 1e-5);
+  }
+}
+
+TEST(MatrixExpression, Exceptions) {
+  Matrix empty, a(2, 3), b(3, 2);
+  EXPECT_THROW(a + b, std::logic_error);
+  EXPECT_THROW(a - b, std::logic_error);
+  EXPECT_THROW(a * a, std::logic_error);
+  EXPECT_THROW(empty * 2.0, std::logic_error);
+  EXPECT_THROW(Transpose(empty), std::logic_error);
+  EXPECT_THROW(MultiplyHadamard(a * b, b), std::logic_error);
+  EXPECT_THROW(a += b, std::logic_error);
+  EXPECT_THROW(a -= a * b, std::logic_error);
+}
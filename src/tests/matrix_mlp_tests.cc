@@ -0,0 +1,354 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+
+#include "matrix_mlp.h"
+
+using namespace s21;
+
+namespace {
+
+// Counts every heap allocation of the test binary.
+std::atomic<std::size_t> allocations{0};
+
+void *Allocate(std::size_t size, std::size_t alignment) {
+  ++allocations;
+  size = (std::max<std::size_t>(size, 1) + alignment - 1) / alignment *
+         alignment;
+  if (void *ptr = std::aligned_alloc(alignment, size)) return ptr;
+  throw std::bad_alloc();
+}
+
+template <typename T>
+std::size_t CountStepAllocations(const Optimizer &optimizer = {}) {
+  BasicMatrixMlp<T> mlp(Topology{64, 32, 10});
+  mlp.SetOptimizer(optimizer);
+  Vector input(64), expected(10, 0.0), output;
+  RandomizeVector(input);
+  expected[3] = 1.0;
+  Matrix inputs(8, 64), targets(8, 10), outputs;
+  RandomizeMatrix(inputs);
+  targets.Fill(0.0);
+
+  const auto step = [&]() {
+    mlp.SetInputLayer(input);
+    mlp.ForwardPropagation();
+    mlp.BackPropagation(expected, 0.1);
+    mlp.CopyOutput(output);
+    mlp.TrainBatch(inputs, targets, 0.1, outputs);
+    mlp.SetInputLayer(input);
+    mlp.ForwardPropagation();
+    mlp.CopyOutput(output);
+  };
+  // The first step brings the batch buffers and the packing buffers of the
+  // products to their size.
+  step();
+  const std::size_t before = allocations;
+  for (int i = 0; i < 10; ++i) step();
+  return allocations - before;
+}
+
+}  // namespace
+
+void *operator new(std::size_t size) {
+  return Allocate(size, alignof(std::max_align_t));
+}
+void *operator new(std::size_t size, std::align_val_t alignment) {
+  return Allocate(size, static_cast<std::size_t>(alignment));
+}
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+TEST(MatrixMlp, NoAllocations) {
+  const std::size_t before = allocations;
+  Vector probe(16);
+  EXPECT_GT(allocations, before);
+
+  EXPECT_EQ(CountStepAllocations<double>(), 0);
+  EXPECT_EQ(CountStepAllocations<float>(), 0);
+  Optimizer adam;
+  adam.type = Optimizer::Type::kAdam;
+  EXPECT_EQ(CountStepAllocations<double>(adam), 0);
+  EXPECT_EQ(CountStepAllocations<float>(adam), 0);
+}
+
+TEST(MatrixMlp, DataParallelGradients) {
+  MatrixMlp whole(Topology{20, 12, 5});
+  MatrixMlp sharded(Topology{20, 12, 5});
+  const auto [weights, biases] = whole.GetMlp();
+  sharded.SetMlp(weights, biases);
+  Matrix inputs(8, 20), expected(8, 5), outputs;
+  RandomizeMatrix(inputs);
+  RandomizeMatrix(expected);
+
+  std::unique_ptr<Workspace> workspace = whole.CreateWorkspace();
+  whole.ComputeGradients(inputs, expected, *workspace, outputs);
+  whole.ApplyGradients(*workspace, 0.5 / 8);
+
+  std::unique_ptr<Workspace> first = sharded.CreateWorkspace();
+  std::unique_ptr<Workspace> second = sharded.CreateWorkspace();
+  Matrix first_inputs(5, 20), first_expected(5, 5);
+  Matrix second_inputs(3, 20), second_expected(3, 5);
+  std::copy(inputs.begin(), inputs[5], first_inputs.begin());
+  std::copy(inputs[5], inputs.end(), second_inputs.begin());
+  std::copy(expected.begin(), expected[5], first_expected.begin());
+  std::copy(expected[5], expected.end(), second_expected.begin());
+  sharded.ComputeGradients(first_inputs, first_expected, *first, outputs);
+  sharded.ComputeGradients(second_inputs, second_expected, *second, outputs);
+  sharded.ReduceGradients(*first, *second);
+  sharded.ApplyGradients(*first, 0.5 / 8);
+
+  const auto [whole_weights, whole_biases] = whole.GetMlp();
+  const auto [sharded_weights, sharded_biases] = sharded.GetMlp();
+  for (std::size_t i = 0; i < whole_weights.size(); ++i) {
+    for (std::size_t j = 0; j < whole_weights[i].GetSize(); ++j) {
+      EXPECT_NEAR(whole_weights[i].Data()[j], sharded_weights[i].Data()[j],
+                  1e-12);
+    }
+    for (std::size_t j = 0; j < whole_biases[i].GetSize(); ++j) {
+      EXPECT_NEAR(whole_biases[i].Data()[j], sharded_biases[i].Data()[j],
+                  1e-12);
+    }
+    EXPECT_GT(std::fabs(whole_weights[i].Data()[0] - weights[i].Data()[0]),
+              0.0);
+  }
+}
+
+TEST(MatrixMlp, ActivationGradients) {
+  Topology topology{6, 5, 4, 3};
+  topology.SetActivation(Activation::kTanh, 1);
+  topology.SetActivation(Activation::kRelu, 2);
+  MatrixMlp mlp(topology);
+  Matrix inputs(1, 6), expected(1, 3), outputs;
+  RandomizeMatrix(inputs);
+  RandomizeMatrix(expected);
+  const auto [weights, biases] = mlp.GetMlp();
+
+  std::unique_ptr<Workspace> workspace = mlp.CreateWorkspace();
+  mlp.ComputeGradients(inputs, expected, *workspace, outputs);
+  mlp.ApplyGradients(*workspace, 1.0);
+  const auto [updated, updated_biases] = mlp.GetMlp();
+
+  // The deltas are the gradients of half the squared error.
+  const auto loss = [&](const Tensor& w) {
+    MatrixMlp probe(topology);
+    probe.SetMlp(w, biases);
+    probe.SetInputLayer(Vector(inputs.begin(), inputs.end()));
+    probe.ForwardPropagation();
+    double sum = 0.0;
+    const Vector output = probe.GetOutput();
+    for (std::size_t i = 0; i < output.size(); ++i) {
+      sum += 0.5 * (output[i] - expected(0, i)) * (output[i] - expected(0, i));
+    }
+    return sum;
+  };
+  const double eps = 1e-6;
+  for (std::size_t l = 0; l < weights.size(); ++l) {
+    for (std::size_t j = 0; j < weights[l].GetSize(); ++j) {
+      Tensor plus = weights, minus = weights;
+      plus[l].Data()[j] += eps;
+      minus[l].Data()[j] -= eps;
+      const double numeric = (loss(plus) - loss(minus)) / (2 * eps);
+      EXPECT_NEAR(weights[l].Data()[j] - updated[l].Data()[j], numeric, 1e-6);
+    }
+  }
+}
+
+TEST(MatrixMlp, Optimizers) {
+  constexpr double kLr = 0.05;
+  const Topology topology{10, 7, 4};
+  Matrix inputs(4, 10), expected(4, 4), outputs;
+  RandomizeMatrix(inputs);
+  RandomizeMatrix(expected);
+
+  for (Optimizer::Type type :
+       {Optimizer::Type::kMomentum, Optimizer::Type::kNesterov,
+        Optimizer::Type::kAdam}) {
+    Optimizer optimizer;
+    optimizer.type = type;
+    MatrixMlp mlp(topology);
+    mlp.SetOptimizer(optimizer);
+    auto [weights, biases] = mlp.GetMlp();
+    // Parameters and moments of the update computed here, the weights then
+    // the biases of every layer.
+    Tensor params, first, second;
+    for (std::size_t l = 0; l < weights.size(); ++l) {
+      params.push_back(weights[l]);
+      params.push_back(biases[l]);
+    }
+    for (const Matrix &param : params) {
+      first.emplace_back(param.GetRows(), param.GetCols());
+      first.back().Fill(0.0);
+    }
+    second = first;
+
+    // The SGD model gives the gradients averaged over the batch.
+    MatrixMlp sgd(topology);
+    std::unique_ptr<Workspace> workspace = sgd.CreateWorkspace();
+    for (int t = 1; t <= 3; ++t) {
+      Tensor w, b;
+      for (std::size_t p = 0; p < params.size(); p += 2) {
+        w.push_back(params[p]);
+        b.push_back(params[p + 1]);
+      }
+      sgd.SetMlp(w, b);
+      sgd.ComputeGradients(inputs, expected, *workspace, outputs);
+      sgd.ApplyGradients(*workspace, 1.0 / 4);
+      const auto [stepped, stepped_biases] = sgd.GetMlp();
+
+      for (std::size_t p = 0; p < params.size(); ++p) {
+        const Matrix &next = p % 2 ? stepped_biases[p / 2] : stepped[p / 2];
+        for (std::size_t i = 0; i < params[p].GetSize(); ++i) {
+          const double g = params[p].Data()[i] - next.Data()[i];
+          double &w_i = params[p].Data()[i];
+          double &m = first[p].Data()[i];
+          double &v = second[p].Data()[i];
+          if (type == Optimizer::Type::kAdam) {
+            m = optimizer.beta1 * m + (1 - optimizer.beta1) * g;
+            v = optimizer.beta2 * v + (1 - optimizer.beta2) * g * g;
+            const double lr = kLr *
+                              std::sqrt(1 - std::pow(optimizer.beta2, t)) /
+                              (1 - std::pow(optimizer.beta1, t));
+            w_i -= lr * m / (std::sqrt(v) + optimizer.epsilon);
+          } else {
+            m = optimizer.momentum * m + g;
+            w_i -= kLr * (type == Optimizer::Type::kNesterov
+                              ? g + optimizer.momentum * m
+                              : m);
+          }
+        }
+      }
+      mlp.TrainBatch(inputs, expected, kLr, outputs);
+    }
+
+    const auto [trained, trained_biases] = mlp.GetMlp();
+    for (std::size_t p = 0; p < params.size(); ++p) {
+      const Matrix &actual = p % 2 ? trained_biases[p / 2] : trained[p / 2];
+      for (std::size_t i = 0; i < params[p].GetSize(); ++i) {
+        EXPECT_NEAR(actual.Data()[i], params[p].Data()[i], 1e-10);
+      }
+    }
+  }
+}
+
+TEST(MatrixMlp, LayerViews) {
+  SeedRandomWeights(9);
+  MatrixMlp mlp(Topology{5, 4, 3});
+  const LayerViews views = mlp.GetLayerViews();
+  const auto &layers = std::get<std::vector<LayerView>>(views);
+  ASSERT_EQ(layers.size(), 2);
+  EXPECT_TRUE(layers[0].weights.IsContiguous());
+  EXPECT_EQ(layers[0].weights.GetRows(), 5);
+  EXPECT_EQ(layers[1].biases.GetCols(), 3);
+
+  // The views follow the training of the model.
+  const Vector input{0.1, 0.5, 0.9, 0.3, 0.2};
+  mlp.SetInputLayer(input);
+  mlp.ForwardPropagation();
+  mlp.BackPropagation({0.0, 1.0, 0.0}, 0.5);
+  const auto [weights, biases] = mlp.GetMlp();
+  for (std::size_t l = 0; l < layers.size(); ++l) {
+    EXPECT_EQ(weights[l].GetRows(), layers[l].weights.GetRows());
+    for (std::size_t i = 0; i < weights[l].GetRows(); ++i) {
+      for (std::size_t j = 0; j < weights[l].GetCols(); ++j) {
+        EXPECT_EQ(weights[l](i, j), layers[l].weights(i, j));
+      }
+    }
+  }
+
+  FloatMatrixMlp float_mlp(Topology{5, 4, 3});
+  float_mlp.SetMlp(weights, biases);
+  const LayerViews float_views = float_mlp.GetLayerViews();
+  const auto &float_layers = std::get<std::vector<FloatLayerView>>(float_views);
+  EXPECT_EQ(float_layers[1].biases(0, 2), static_cast<float>(biases[1](0, 2)));
+}
+
+TEST(MatrixMlp, TrainBatchAppliesBatchGradient) {
+  for (std::size_t rows : {1, 8}) {
+    MatrixMlp batch(Topology{10, 7, 6, 4});
+    MatrixMlp reference(Topology{10, 7, 6, 4});
+    const auto [weights, biases] = batch.GetMlp();
+    reference.SetMlp(weights, biases);
+    Matrix inputs(rows, 10), expected(rows, 4), outputs;
+    RandomizeMatrix(inputs);
+    RandomizeMatrix(expected);
+
+    batch.TrainBatch(inputs, expected, 0.5, outputs);
+    std::unique_ptr<Workspace> workspace = reference.CreateWorkspace();
+    reference.ComputeGradients(inputs, expected, *workspace, outputs);
+    reference.ApplyGradients(*workspace, 0.5 / static_cast<double>(rows));
+
+    const auto [trained, trained_biases] = batch.GetMlp();
+    const auto [stepped, stepped_biases] = reference.GetMlp();
+    for (std::size_t i = 0; i < trained.size(); ++i) {
+      for (std::size_t j = 0; j < trained[i].GetSize(); ++j) {
+        EXPECT_NEAR(trained[i].Data()[j], stepped[i].Data()[j], 1e-12);
+      }
+      for (std::size_t j = 0; j < trained_biases[i].GetSize(); ++j) {
+        EXPECT_NEAR(trained_biases[i].Data()[j], stepped_biases[i].Data()[j],
+                    1e-12);
+      }
+    }
+  }
+}
+
+TEST(MatrixMlp, TrainBatchAsyncMatchesTrainBatch) {
+  // A single Hogwild worker trains exactly like the synchronous step.
+  MatrixMlp shared(Topology{10, 7, 6, 4});
+  MatrixMlp async(Topology{10, 7, 6, 4});
+  const auto [weights, biases] = shared.GetMlp();
+  async.SetMlp(weights, biases);
+  std::unique_ptr<Workspace> workspace = async.CreateWorkspace();
+
+  for (std::size_t rows : {8, 1, 5}) {
+    Matrix inputs(rows, 10), expected(rows, 4), outputs, async_outputs;
+    RandomizeMatrix(inputs);
+    RandomizeMatrix(expected);
+    shared.TrainBatch(inputs, expected, 0.5, outputs);
+    async.TrainBatchAsync(inputs, expected, 0.5, *workspace, async_outputs);
+    EXPECT_TRUE(std::equal(outputs.begin(), outputs.end(),
+                           async_outputs.begin(), async_outputs.end()));
+  }
+
+  const auto [trained, trained_biases] = shared.GetMlp();
+  const auto [async_trained, async_biases] = async.GetMlp();
+  for (std::size_t i = 0; i < trained.size(); ++i) {
+    EXPECT_TRUE(std::equal(trained[i].begin(), trained[i].end(),
+                           async_trained[i].begin()));
+    EXPECT_TRUE(std::equal(trained_biases[i].begin(), trained_biases[i].end(),
+                           async_biases[i].begin()));
+  }
+}
+
+TEST(MatrixMlp, MathModeIsPerModel) {
+  MatrixMlp exact(Topology{20, 12, 5});
+  MatrixMlp fast(Topology{20, 12, 5});
+  const auto [weights, biases] = exact.GetMlp();
+  fast.SetMlp(weights, biases);
+  Vector input(20);
+  RandomizeVector(input);
+  for (double &value : input) value *= 10.0;
+
+  exact.SetInputLayer(input);
+  exact.ForwardPropagation();
+  const Vector before = exact.GetOutput();
+  fast.SetMathMode(MathMode::kFast);
+  fast.SetInputLayer(input);
+  fast.ForwardPropagation();
+  const Vector approximate = fast.GetOutput();
+  // The fast model does not change the sigmoid of the other one.
+  exact.ForwardPropagation();
+  EXPECT_EQ(exact.GetOutput(), before);
+  EXPECT_EQ(exact.GetMathMode(), MathMode::kExact);
+  for (std::size_t i = 0; i < before.size(); ++i) {
+    EXPECT_NEAR(approximate[i], before[i], 1e-13);
+  }
+}
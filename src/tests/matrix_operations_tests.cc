@@ -9,12 +9,12 @@ using namespace s21;
 constexpr double kEps = 1e-6;
 
 bool IsEqualMatrices(const Matrix& m1, const Matrix& m2) {
-  if (m1.empty() or m2.empty() or m1.size() != m2.size() or
-      m1[0].size() != m2[0].size()) {
+  if (m1.IsEmpty() or m2.IsEmpty() or m1.GetRows() != m2.GetRows() or
+      m1.GetCols() != m2.GetCols()) {
     return false;
   }
-  for (std::size_t i{0u}; i < m1.size(); ++i) {
-    for (std::size_t j{0u}; j < m1[0].size(); ++j) {
+  for (std::size_t i{0u}; i < m1.GetRows(); ++i) {
+    for (std::size_t j{0u}; j < m1.GetCols(); ++j) {
       if (std::fabs(m1[i][j] - m2[i][j]) >= kEps) {
         return false;
       }
@@ -25,7 +25,7 @@ bool IsEqualMatrices(const Matrix& m1, const Matrix& m2) {
 }
 
 TEST(MatrixOperations, RandomizeMatrix) {
-  Matrix m = Matrix(1000, Vector(1000));
+  Matrix m = Matrix(1000, 1000);
   EXPECT_NO_THROW(RandomizeMatrix(m));
 }
 
@@ -225,6 +225,24 @@ TEST(MatrixOperations, MultiplyWinograd3) {
   EXPECT_TRUE(IsEqualMatrices(m, m3));
 }
 
+TEST(MatrixOperations, MultiplyWinograd4) {
+  Matrix m1 = {{1}, {2}, {3}, {4}, {5}};
+  Matrix m2 = {{1, 2, 3, 4, 5}};
+  EXPECT_TRUE(IsEqualMatrices(MultiplyWinograd(m1, m2), m1 * m2));
+
+  Matrix m3(150, 201), m4(201, 130);
+  RandomizeMatrix(m3);
+  RandomizeMatrix(m4);
+  Matrix expected = m3 * m4;
+  const std::size_t threads = GetThreadPool().GetThreadsCount();
+  GetThreadPool().Resize(3);
+  Matrix m = MultiplyWinograd(m3, m4);
+  GetThreadPool().Resize(threads);
+  for (std::size_t i = 0; i < m.GetSize(); ++i) {
+    EXPECT_NEAR(m.Data()[i], expected.Data()[i], 1e-9);
+  }
+}
+
 TEST(MatrixOperations, Multiply) {
   Matrix m1 = {{1}, {2}, {3}, {4}, {5}};
   Matrix m2 = {{1, 2, 3, 4, 5}};
@@ -297,6 +315,87 @@ TEST(MatrixOperations, ActivateDerivative) {
   EXPECT_TRUE(IsEqualMatrices(m, m2));
 }
 
+TEST(MatrixOperations, MultiplyTransposed) {
+  Matrix m1 = {{1, 2, 3}, {4, 5, 6}};
+  Matrix m2 = {{7, 8}, {9, 10}};
+  Matrix m3 = {{43, 48}, {59, 66}, {75, 84}};
+  EXPECT_TRUE(IsEqualMatrices(MultiplyTN(m1, m2), m3));
+  EXPECT_TRUE(IsEqualMatrices(MultiplyTN(m1, m2), Transpose(m1) * m2));
+
+  Matrix m4 = {{1, 0, 2}, {3, 1, 1}};
+  Matrix m5 = {{7, 8}, {16, 23}};
+  EXPECT_TRUE(IsEqualMatrices(MultiplyNT(m1, m4), m5));
+  EXPECT_TRUE(IsEqualMatrices(MultiplyNT(m1, m4), m1 * Transpose(m4)));
+}
+TEST(MatrixOperations, InPlace) {
+  Matrix m1 = {{1, 2, 3}, {4, 5, 6}};
+  Matrix m2 = {{6, 5, 4}, {3, 2, 1}};
+  Matrix m = m1;
+  AddInPlace(m, m2);
+  EXPECT_TRUE(IsEqualMatrices(m, m1 + m2));
+  SubInPlace(m, m2);
+  EXPECT_TRUE(IsEqualMatrices(m, m1));
+  MultiplyHadamardInPlace(m, m2);
+  EXPECT_TRUE(IsEqualMatrices(m, MultiplyHadamard(m1, m2)));
+  MultiplyNumberInPlace(m, 0.5);
+  EXPECT_TRUE(IsEqualMatrices(m, MultiplyHadamard(m1, m2) * 0.5));
+  m = m1;
+  AxpyInto(m, -2.0, m2);
+  EXPECT_TRUE(IsEqualMatrices(m, m1 - m2 * 2.0));
+  SubtractInto(m, m2, m1);
+  EXPECT_TRUE(IsEqualMatrices(m, m2 - m1));
+  ActivateInto(m, m1, relu);
+  EXPECT_TRUE(IsEqualMatrices(m, Activate(m1, relu)));
+  ActivateDerivativeInto(m, m1, sigmoid_derivative);
+  EXPECT_TRUE(IsEqualMatrices(m, ActivateDerivative(m1, sigmoid_derivative)));
+  ActivateInto(m, m1, Activation::kTanh);
+  EXPECT_TRUE(IsEqualMatrices(m, Activate(m1, s21::tanh)));
+  ActivateDerivativeInto(m, m, Activation::kTanh);
+  EXPECT_TRUE(IsEqualMatrices(
+      m, ActivateDerivative(Activate(m1, s21::tanh),
+                            [](double y) { return 1 - y * y; })));
+}
+TEST(MatrixOperations, MultiplyInto) {
+  Matrix m1 = {{1, 2, 3}, {4, 5, 6}};
+  Matrix m2 = {{7, 8}, {9, 10}};
+  Matrix m3 = {{1, 0, 2}, {3, 1, 1}};
+  Matrix m;
+  MultiplyInto(m, Transpose(m1), m2);
+  EXPECT_TRUE(IsEqualMatrices(m, MultiplyTN(m1, m2)));
+  MultiplyTNInto(m, m1, m2, -1.0, 1.0);
+  EXPECT_TRUE(IsEqualMatrices(m, Matrix(3, 2)));
+  MultiplyNTInto(m, m1, m3);
+  EXPECT_TRUE(IsEqualMatrices(m, MultiplyNT(m1, m3)));
+  MultiplyNTInto(m, m1, m3, 2.0, -1.0);
+  EXPECT_TRUE(IsEqualMatrices(m, MultiplyNT(m1, m3)));
+  EXPECT_THROW(MultiplyInto(m, m1, m3, 1.0, 1.0), std::logic_error);
+}
+
+TEST(MatrixOperations, GerInto) {
+  const std::size_t threads = GetThreadPool().GetThreadsCount();
+  GetThreadPool().Resize(3);
+  for (std::size_t rows : {std::size_t{7}, std::size_t{600}}) {
+    Matrix x(1, rows), y(1, 300), m(rows, 300);
+    RandomizeMatrix(x);
+    RandomizeMatrix(y);
+    RandomizeMatrix(m);
+    x(0, 1) = 0.0;
+    Matrix expected = m;
+    MultiplyTNInto(expected, x, y, -0.5, 1.0);
+    GerInto(m, -0.5, x, y);
+    EXPECT_TRUE(IsEqualMatrices(m, expected));
+
+    FloatMatrix fx(x), fy(y), fm(m);
+    FloatMatrix fexpected = fm;
+    MultiplyTNInto(fexpected, fx, fy, 2.0, 1.0);
+    GerInto(fm, 2.0, fx, fy);
+    EXPECT_TRUE(IsEqualMatrices(Matrix(fm), Matrix(fexpected)));
+  }
+  GetThreadPool().Resize(threads);
+  Matrix m(3, 2);
+  EXPECT_THROW(GerInto(m, 1.0, Matrix(1, 2), Matrix(1, 2)), std::logic_error);
+}
+
 TEST(MatrixOperations, Exceptions) {
   Matrix m1;
   Matrix m2{{1, 2, 3}, {4, 5, 6}};
@@ -309,6 +408,11 @@ TEST(MatrixOperations, Exceptions) {
   EXPECT_THROW(ActivateDerivative(m1, sigmoid_derivative), std::logic_error);
   EXPECT_THROW(MultiplyWinograd(m1, m2), std::logic_error);
   EXPECT_THROW(Multiply(m1, m2), std::logic_error);
+  EXPECT_THROW(MultiplyTN(m2, Transpose(m2)), std::logic_error);
+  EXPECT_THROW(MultiplyNT(m2, Transpose(m2)), std::logic_error);
+  EXPECT_THROW(SubInPlace(m1, m2), std::logic_error);
+  EXPECT_THROW(AxpyInto(m2, 1.0, Transpose(m2)), std::logic_error);
+  EXPECT_THROW(MultiplyNumberInPlace(m1, 1.0), std::logic_error);
   PrintVector(v);
   PrintMatrix(m1);
   RandomizeVector(v);
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "matrix.h"
+
+using namespace s21;
+
+TEST(Matrix, Construct) {
+  Matrix m(3, 4, 1.5);
+  EXPECT_EQ(m.GetRows(), 3u);
+  EXPECT_EQ(m.GetCols(), 4u);
+  EXPECT_EQ(m.GetSize(), 12u);
+  EXPECT_FALSE(m.IsEmpty());
+  for (double value : m) {
+    EXPECT_DOUBLE_EQ(value, 1.5);
+  }
+  EXPECT_TRUE(Matrix().IsEmpty());
+}
+
+TEST(Matrix, InitializerList) {
+  Matrix m = {{1, 2, 3}, {4, 5, 6}};
+  EXPECT_EQ(m.GetRows(), 2u);
+  EXPECT_EQ(m.GetCols(), 3u);
+  EXPECT_DOUBLE_EQ(m(1, 0), 4);
+  EXPECT_DOUBLE_EQ(m[0][2], 3);
+  EXPECT_DOUBLE_EQ(m.Data()[4], 5);
+}
+
+TEST(Matrix, Aligned) {
+  for (std::size_t size = 1; size < 100; size += 7) {
+    Matrix m(size, size + 1);
+    auto address = reinterpret_cast<std::uintptr_t>(m.Data());
+    EXPECT_EQ(address % kMatrixAlignment, 0u);
+  }
+}
+
+TEST(Matrix, Resize) {
+  Matrix m(2, 2);
+  m.Resize(3, 5);
+  EXPECT_EQ(m.GetRows(), 3u);
+  EXPECT_EQ(m.GetCols(), 5u);
+  EXPECT_EQ(m.GetSize(), 15u);
+  m.Fill(2.0);
+  EXPECT_DOUBLE_EQ(m(2, 4), 2.0);
+}
+
+TEST(Matrix, Views) {
+  Matrix m = {{1, 2, 3}, {4, 5, 6}};
+  ConstMatrixView view = m;
+  EXPECT_TRUE(view.IsContiguous());
+  EXPECT_DOUBLE_EQ(view(1, 2), 6);
+
+  ConstMatrixView transposed = view.Transposed();
+  EXPECT_EQ(transposed.GetRows(), 3u);
+  EXPECT_EQ(transposed.GetCols(), 2u);
+  EXPECT_FALSE(transposed.IsContiguous());
+  EXPECT_DOUBLE_EQ(transposed(2, 0), 3);
+  EXPECT_DOUBLE_EQ(transposed(0, 1), 4);
+
+  MatrixView block = m.GetView().Block(0, 1, 2, 2);
+  block(1, 1) = 10;
+  EXPECT_DOUBLE_EQ(m(1, 2), 10);
+  EXPECT_DOUBLE_EQ(Matrix(block)(0, 0), 2);
+}
+
+TEST(Matrix, Exceptions) {
+  EXPECT_THROW((Matrix{{1, 2}, {3}}), std::invalid_argument);
+}
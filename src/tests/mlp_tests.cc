@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+#include "mlp.h"
+
+using namespace s21;
+
+namespace {
+
+Dataset RandomDataset(std::size_t count, std::size_t size) {
+  std::mt19937 gen(13);
+  std::uniform_real_distribution<double> value(0.0, 1.0);
+  Dataset dataset;
+  for (std::size_t i = 0; i < count; ++i) {
+    Image::Pixels pixels(size);
+    for (double &pixel : pixels) pixel = value(gen);
+    dataset.emplace_back(pixels, 1 + i % 4);
+  }
+  return dataset;
+}
+
+// Trains a fresh model for a few epochs with a fixed seed.
+std::unique_ptr<MLP> TrainModel(
+    std::size_t threads, std::size_t batch_size,
+    Config::TrainType train_type = Config::TrainType::kTrain,
+    Config::ModelType model_type = Config::ModelType::kMatrix) {
+  SeedRandomWeights(5);
+  auto mlp = std::make_unique<MLP>(Topology{16, 12, 4});
+  mlp->SetType(model_type);
+  mlp->SetMFunc([](Metrics) {});
+  mlp->SetPFunc([](int) {});
+  mlp->SetFPFunc([](double) {});
+  mlp->SetTrainDataset(RandomDataset(120, 16));
+  mlp->SetSeed(5);
+  mlp->SetEpochs(3);
+  mlp->SetThreads(threads);
+  mlp->SetBatchSize(batch_size);
+  mlp->SetTrainType(train_type);
+  mlp->Train();
+  return mlp;
+}
+
+std::string SavedWeights(MLP &mlp) {
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "mlp_tests_weights.bin")
+          .string();
+  mlp.Save(path);
+  std::ifstream file(path, std::ios::binary);
+  std::string bytes{std::istreambuf_iterator<char>(file),
+                    std::istreambuf_iterator<char>()};
+  std::remove(path.c_str());
+  return bytes;
+}
+
+}  // namespace
+
+TEST(MLP, DataParallelTrainingIsReproducible) {
+  const std::size_t threads = GetThreadPool().GetThreadsCount();
+  std::unique_ptr<MLP> first = TrainModel(3, 8);
+  std::unique_ptr<MLP> second = TrainModel(3, 8);
+  EXPECT_EQ(first->GetMetrics().GetWorkers(), 3);
+  EXPECT_EQ(SavedWeights(*first), SavedWeights(*second));
+  // The workers have their own pool, the shared one is left as it is.
+  EXPECT_EQ(GetThreadPool().GetThreadsCount(), threads);
+}
+
+TEST(MLP, WorkersCappedByBatchSize) {
+  EXPECT_EQ(TrainModel(3, 2)->GetMetrics().GetWorkers(), 2);
+  // Single samples cannot be split, so they train serially.
+  std::unique_ptr<MLP> parallel = TrainModel(3, 1);
+  EXPECT_EQ(parallel->GetMetrics().GetWorkers(), 0);
+  EXPECT_EQ(SavedWeights(*parallel), SavedWeights(*TrainModel(1, 1)));
+}
+
+TEST(MLP, HogwildWithOneWorker) {
+  // One worker walks the whole shuffled dataset like the synchronous epochs.
+  EXPECT_EQ(SavedWeights(*TrainModel(1, 4, Config::TrainType::kHogwild)),
+            SavedWeights(*TrainModel(1, 4)));
+}
+
+TEST(MLP, HogwildFallsBackWithoutWorkspaces) {
+  // The graph model has no workspaces, so it trains through the epochs.
+  const auto graph = Config::ModelType::kGraph;
+  EXPECT_EQ(
+      SavedWeights(*TrainModel(3, 1, Config::TrainType::kHogwild, graph)),
+      SavedWeights(*TrainModel(3, 1, Config::TrainType::kTrain, graph)));
+}
+
+TEST(MLP, SetTypeKeepsModelOnFailure) {
+  MLP mlp{Topology{16, 12, 4}};
+  const Vector input(16, 0.5);
+  const Vector output = mlp.Predict(input);
+  // No static model is compiled for this topology.
+  EXPECT_THROW(mlp.SetType(Config::ModelType::kStatic), std::invalid_argument);
+  EXPECT_EQ(mlp.GetType(), Config::ModelType::kMatrix);
+  EXPECT_EQ(mlp.Predict(input), output);
+}
+
+TEST(MLP, SetTypeKeepsModelWithUnsupportedOptimizer) {
+  MLP mlp{Topology{16, 12, 4}};
+  Optimizer adam;
+  adam.type = Optimizer::Type::kAdam;
+  mlp.SetOptimizer(adam);
+  // The graph model only supports SGD.
+  EXPECT_THROW(mlp.SetType(Config::ModelType::kGraph), std::logic_error);
+  EXPECT_EQ(mlp.GetType(), Config::ModelType::kMatrix);
+  EXPECT_EQ(mlp.GetOptimizer().type, Optimizer::Type::kAdam);
+
+  mlp.SetOptimizer(Optimizer{});
+  mlp.SetType(Config::ModelType::kGraph);
+  EXPECT_EQ(mlp.GetType(), Config::ModelType::kGraph);
+  EXPECT_THROW(mlp.SetOptimizer(adam), std::logic_error);
+  EXPECT_EQ(mlp.GetOptimizer().type, Optimizer::Type::kSgd);
+}
+
+TEST(MLP, SetPrecisionKeepsWeights) {
+  MLP mlp{Topology{16, 12, 4}};
+  const Vector input(16, 0.5);
+  const Vector output = mlp.Predict(input);
+  mlp.SetPrecision(Config::Precision::kFloat);
+  EXPECT_EQ(mlp.GetPrecision(), Config::Precision::kFloat);
+  const Vector rounded = mlp.Predict(input);
+  for (std::size_t i = 0; i < output.size(); ++i) {
+    EXPECT_NEAR(rounded[i], output[i], 1e-5);
+  }
+}
+
+TEST(MLP, ScalingMetrics) {
+  Metrics metrics(4);
+  metrics.AddScaling(3, 4.0, 2.0);
+  metrics.AddScaling(3, 2.0, 2.0);
+  // Workers busy 6 s over 4 s of parallel steps.
+  EXPECT_DOUBLE_EQ(metrics.GetParallelism(), 1.5);
+  EXPECT_DOUBLE_EQ(metrics.GetScalingEfficiency(), 0.5);
+}
@@ -0,0 +1,70 @@
+#include <chrono>
+#include <iostream>
+
+#include "mlp.h"
+
+using namespace s21;
+
+namespace {
+
+constexpr char kTrainDataset[] = "../datasets/emnist-letters-train.csv";
+constexpr char kTestDataset[] = "../datasets/emnist-letters-test.csv";
+constexpr double kTargetAccuracy = 0.8;
+constexpr std::size_t kMaxEpochs = 20;
+constexpr std::size_t kBatchSize = 32;
+
+// Trains one epoch at a time until the test accuracy reaches the target and
+// reports the epochs and the training time it took.
+void Run(const std::string& name, Optimizer::Type type, double lr,
+         const Dataset& train, const Dataset& test) {
+  MLP mlp{Topology{784, 128, 26}};
+  mlp.SetMFunc([](Metrics) {});
+  mlp.SetPFunc([](int) {});
+  mlp.SetFPFunc([](double) {});
+  mlp.SetTrainDataset(train);
+  mlp.SetTestDataset(test);
+  mlp.SetSeed(1);
+  mlp.SetEpochs(1);
+  mlp.SetBatchSize(kBatchSize);
+  mlp.SetLearningRate(lr);
+  Optimizer optimizer;
+  optimizer.type = type;
+  mlp.SetOptimizer(optimizer);
+
+  std::chrono::duration<double> elapsed{0};
+  double accuracy = 0.0;
+  std::size_t epoch = 0;
+  while (epoch < kMaxEpochs and accuracy < kTargetAccuracy) {
+    auto start = std::chrono::high_resolution_clock::now();
+    mlp.Train();
+    elapsed += std::chrono::high_resolution_clock::now() - start;
+    mlp.Test();
+    accuracy = mlp.GetMetrics().GetAccuracy();
+    ++epoch;
+  }
+  std::cout << name << ": " << epoch << " epochs, "
+            << std::to_string(elapsed.count()) << " sec, accuracy "
+            << accuracy << (accuracy < kTargetAccuracy ? " (not reached)" : "")
+            << "\n";
+}
+
+}  // namespace
+
+int main() {
+  system("clear");
+  std::cout << GetColor(Color::kCyan) << Align("EPOCHS TO TARGET ACCURACY")
+            << GetColor(Color::kEnd) << "\n\n";
+  const Dataset train = ParseEmnist(kTrainDataset);
+  const Dataset test = ParseEmnist(kTestDataset);
+  std::cout << "Target accuracy " << kTargetAccuracy << ", batches of "
+            << kBatchSize << "\n";
+
+  Run("SGD", Optimizer::Type::kSgd, 0.5, train, test);
+  Run("Momentum", Optimizer::Type::kMomentum, 0.01, train, test);
+  Run("Nesterov", Optimizer::Type::kNesterov, 0.01, train, test);
+  Run("Adam", Optimizer::Type::kAdam, 0.001, train, test);
+
+  std::cout << GetColor(Color::kCyan) << Align(" ") << GetColor(Color::kEnd)
+            << "\n\n";
+  return 0;
+}
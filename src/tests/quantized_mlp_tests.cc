@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "matrix_mlp.h"
+#include "mlp.h"
+#include "quantized_mlp.h"
+
+using namespace s21;
+
+namespace {
+
+// Largest difference of the outputs of a quantized model and of the double
+// model with the same weights on some inputs.
+double MaxError(QuantizedMlp &quantized, const Topology &topology,
+                const Dataset &inputs) {
+  MatrixMlp reference(topology);
+  const auto [weights, biases] = quantized.GetMlp();
+  reference.SetMlp(weights, biases);
+  double error = 0.0;
+  for (const Image &image : inputs) {
+    quantized.SetInputLayer(image.GetPixels());
+    quantized.ForwardPropagation();
+    reference.SetInputLayer(image.GetPixels());
+    reference.ForwardPropagation();
+    const Vector output = quantized.GetOutput();
+    const Vector expected = reference.GetOutput();
+    for (std::size_t i = 0; i < output.size(); ++i) {
+      error = std::max(error, std::fabs(output[i] - expected[i]));
+    }
+  }
+  return error;
+}
+
+Dataset RandomInputs(std::size_t count, std::size_t size, double max) {
+  std::mt19937 gen(11);
+  std::uniform_real_distribution<double> value(0.0, max);
+  Dataset inputs;
+  for (std::size_t i = 0; i < count; ++i) {
+    Image::Pixels pixels(size);
+    for (double &pixel : pixels) pixel = value(gen);
+    inputs.emplace_back(pixels, 1 + i % 4);
+  }
+  return inputs;
+}
+
+}  // namespace
+
+TEST(QuantizedMlp, MatchesDoubleModel) {
+  SeedRandomWeights(21);
+  const Topology topology{32, 24, 8};
+  QuantizedMlp quantized(topology);
+  EXPECT_LT(MaxError(quantized, topology, RandomInputs(50, 32, 1.0)), 0.02);
+}
+
+TEST(QuantizedMlp, TanhOffset) {
+  SeedRandomWeights(22);
+  Topology topology{32, 24, 16, 8};
+  topology.SetActivation(Activation::kTanh, 1);
+  topology.SetActivation(Activation::kTanh, 2);
+  QuantizedMlp quantized(topology);
+  // The layers after a tanh take inputs shifted into [0, 2].
+  EXPECT_DOUBLE_EQ(quantized.GetRanges()[1], 2.0);
+  EXPECT_LT(MaxError(quantized, topology, RandomInputs(50, 32, 1.0)), 0.02);
+}
+
+TEST(QuantizedMlp, Calibration) {
+  SeedRandomWeights(23);
+  Topology topology{32, 24, 8};
+  topology.SetActivation(Activation::kRelu, 1);
+  QuantizedMlp quantized(topology);
+  // Inputs and ReLU outputs beyond the default range of 1 are clamped.
+  const Dataset inputs = RandomInputs(50, 32, 3.0);
+  const double uncalibrated = MaxError(quantized, topology, inputs);
+
+  quantized.Calibrate(inputs);
+  const auto [weights, biases] = quantized.GetMlp();
+  double input_range = 0.0, hidden_range = 0.0;
+  for (const Image &image : inputs) {
+    const Vector &pixels = image.GetPixels();
+    input_range = std::max(input_range,
+                           *std::max_element(pixels.begin(), pixels.end()));
+    for (std::size_t j = 0; j < weights[0].GetCols(); ++j) {
+      double sum = biases[0](0, j);
+      for (std::size_t k = 0; k < pixels.size(); ++k) {
+        sum += pixels[k] * weights[0](k, j);
+      }
+      hidden_range = std::max(hidden_range, relu(sum));
+    }
+  }
+  EXPECT_NEAR(quantized.GetRanges()[0], input_range, 1e-12);
+  EXPECT_NEAR(quantized.GetRanges()[1], hidden_range, 1e-9);
+
+  const double calibrated = MaxError(quantized, topology, inputs);
+  EXPECT_LT(calibrated, 0.02);
+  EXPECT_LT(calibrated, uncalibrated);
+  EXPECT_THROW(quantized.Calibrate({}), std::invalid_argument);
+}
+
+TEST(QuantizedMlp, InferenceOnly) {
+  QuantizedMlp quantized(Topology{4, 3, 2});
+  EXPECT_THROW(quantized.BackPropagation({1.0, 0.0}, 0.1), std::logic_error);
+}
+
+TEST(QuantizedMlp, QuantizeModel) {
+  SeedRandomWeights(24);
+  MLP mlp{Topology{32, 16, 4}};
+  mlp.SetMFunc([](Metrics) {});
+  mlp.SetPFunc([](int) {});
+  mlp.SetFPFunc([](double) {});
+  mlp.SetTestDataset(RandomInputs(200, 32, 1.0));
+  const double delta = mlp.Quantize(0.5);
+  EXPECT_EQ(mlp.GetType(), Config::ModelType::kQuantized);
+  EXPECT_LE(std::fabs(delta), 0.1);
+}
@@ -0,0 +1,277 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+#include "gemm.h"
+#include "matrix_operations.h"
+#include "simd.h"
+
+using namespace s21;
+
+namespace {
+
+constexpr double kEps = 1e-9;
+constexpr std::size_t kSize = 103;
+
+std::vector<SimdLevel> SupportedLevels() {
+  std::vector<SimdLevel> levels;
+  for (SimdLevel level : {SimdLevel::kScalar, SimdLevel::kSse42,
+                          SimdLevel::kAvx2, SimdLevel::kAvx512}) {
+    SetSimdLevel(level);
+    if (GetSimdLevel() == level) levels.push_back(level);
+  }
+  SetSimdLevel(DetectSimdLevel());
+  return levels;
+}
+
+// Largest relative error of fast_exp against the C library and largest
+// absolute error of fast_sigmoid against the exact sigmoid on [-limit, limit].
+template <typename T>
+std::pair<double, double> FastMathErrors(const BasicSimdKernels<T>& kernels,
+                                         double limit) {
+  constexpr std::size_t kPoints = 20001;
+  std::vector<T> x(kPoints), exp(kPoints), sigmoid_values(kPoints);
+  for (std::size_t i = 0; i < kPoints; ++i) {
+    x[i] = static_cast<T>(-limit + 2.0 * limit * i / (kPoints - 1));
+  }
+  kernels.fast_exp(x.data(), exp.data(), kPoints);
+  kernels.fast_sigmoid(x.data(), sigmoid_values.data(), kPoints);
+  double exp_error = 0.0, sigmoid_error = 0.0;
+  for (std::size_t i = 0; i < kPoints; ++i) {
+    const double expected = std::exp(static_cast<double>(x[i]));
+    exp_error = std::max(exp_error, std::fabs(exp[i] - expected) / expected);
+    sigmoid_error =
+        std::max(sigmoid_error, std::fabs(sigmoid_values[i] - sigmoid(x[i])));
+  }
+  return {exp_error, sigmoid_error};
+}
+
+Vector RandomVector(std::size_t size) {
+  Vector vector(size);
+  RandomizeVector(vector);
+  return vector;
+}
+
+}  // namespace
+
+TEST(Simd, Detect) {
+  EXPECT_EQ(GetSimdLevel(), DetectSimdLevel());
+  EXPECT_NE(GetScalarKernels(), nullptr);
+  std::cout << "Detected: " << GetSimdLevelName(DetectSimdLevel()) << '\n';
+}
+
+TEST(Simd, ElementWise) {
+  Vector a = RandomVector(kSize), b = RandomVector(kSize), r(kSize);
+  for (SimdLevel level : SupportedLevels()) {
+    const SimdKernels& kernels = *GetScalarKernels();
+    SetSimdLevel(level);
+    const SimdKernels& simd = GetSimdKernels();
+    for (std::size_t n : {std::size_t{0}, std::size_t{1}, std::size_t{7},
+                          kSize}) {
+      Vector expected(n), actual(n);
+      kernels.add(a.data(), b.data(), expected.data(), n);
+      simd.add(a.data(), b.data(), actual.data(), n);
+      EXPECT_EQ(actual, expected);
+      kernels.sub(a.data(), b.data(), expected.data(), n);
+      simd.sub(a.data(), b.data(), actual.data(), n);
+      EXPECT_EQ(actual, expected);
+      kernels.mul(a.data(), b.data(), expected.data(), n);
+      simd.mul(a.data(), b.data(), actual.data(), n);
+      EXPECT_EQ(actual, expected);
+      kernels.scale(a.data(), 0.3, expected.data(), n);
+      simd.scale(a.data(), 0.3, actual.data(), n);
+      EXPECT_EQ(actual, expected);
+      kernels.relu(a.data(), expected.data(), n);
+      simd.relu(a.data(), actual.data(), n);
+      EXPECT_EQ(actual, expected);
+      kernels.relu_derivative(a.data(), expected.data(), n);
+      simd.relu_derivative(a.data(), actual.data(), n);
+      EXPECT_EQ(actual, expected);
+      kernels.sigmoid_derivative(a.data(), expected.data(), n);
+      simd.sigmoid_derivative(a.data(), actual.data(), n);
+      EXPECT_EQ(actual, expected);
+      kernels.sigmoid(a.data(), expected.data(), n);
+      simd.sigmoid(a.data(), actual.data(), n);
+      EXPECT_EQ(actual, expected);
+      kernels.tanh(a.data(), expected.data(), n);
+      simd.tanh(a.data(), actual.data(), n);
+      EXPECT_EQ(actual, expected);
+      kernels.tanh_derivative(a.data(), expected.data(), n);
+      simd.tanh_derivative(a.data(), actual.data(), n);
+      for (std::size_t i = 0; i < n; ++i) {
+        EXPECT_NEAR(actual[i], expected[i], kEps);
+      }
+
+      expected = b;
+      actual = b;
+      kernels.axpy(-0.7, a.data(), expected.data(), n);
+      simd.axpy(-0.7, a.data(), actual.data(), n);
+      for (std::size_t i = 0; i < n; ++i) {
+        EXPECT_NEAR(actual[i], expected[i], kEps);
+      }
+      EXPECT_NEAR(simd.dot(a.data(), b.data(), n),
+                  kernels.dot(a.data(), b.data(), n), kEps);
+    }
+  }
+  SetSimdLevel(DetectSimdLevel());
+}
+
+TEST(Simd, InPlace) {
+  Vector a = RandomVector(kSize), expected(kSize);
+  GetScalarKernels()->add(a.data(), a.data(), expected.data(), kSize);
+  GetSimdKernels().add(a.data(), a.data(), a.data(), kSize);
+  EXPECT_EQ(a, expected);
+}
+
+TEST(Simd, Gemm) {
+  Matrix a(45, 70), b(70, 37);
+  RandomizeMatrix(a);
+  RandomizeMatrix(b);
+  SetSimdLevel(SimdLevel::kScalar);
+  Matrix expected(45, 37);
+  Gemm(a, b, expected);
+  for (SimdLevel level : SupportedLevels()) {
+    SetSimdLevel(level);
+    Matrix actual(45, 37);
+    Gemm(a, b, actual);
+    for (std::size_t i = 0; i < actual.GetSize(); ++i) {
+      EXPECT_NEAR(actual.Data()[i], expected.Data()[i], kEps);
+    }
+  }
+  SetSimdLevel(DetectSimdLevel());
+}
+
+TEST(Simd, Float) {
+  const Vector a = RandomVector(kSize), b = RandomVector(kSize);
+  const std::vector<float> fa(a.begin(), a.end()), fb(b.begin(), b.end());
+  FloatMatrix ma(37, 29), mb(29, 41);
+  RandomizeMatrix(ma);
+  RandomizeMatrix(mb);
+  SetSimdLevel(SimdLevel::kScalar);
+  FloatMatrix expected_product(37, 41);
+  Gemm(ma, mb, expected_product);
+  for (SimdLevel level : SupportedLevels()) {
+    const BasicSimdKernels<float>& kernels = *GetScalarKernels<float>();
+    SetSimdLevel(level);
+    const BasicSimdKernels<float>& simd = GetSimdKernels<float>();
+    EXPECT_EQ(simd.level, level);
+    std::vector<float> expected(kSize), actual(kSize);
+    kernels.mul(fa.data(), fb.data(), expected.data(), kSize);
+    simd.mul(fa.data(), fb.data(), actual.data(), kSize);
+    EXPECT_EQ(actual, expected);
+    kernels.relu_derivative(fa.data(), expected.data(), kSize);
+    simd.relu_derivative(fa.data(), actual.data(), kSize);
+    EXPECT_EQ(actual, expected);
+    simd.sigmoid(fa.data(), actual.data(), kSize);
+    for (std::size_t i = 0; i < kSize; ++i) {
+      EXPECT_NEAR(actual[i], sigmoid(a[i]), 1e-6);
+    }
+    EXPECT_NEAR(simd.dot(fa.data(), fb.data(), kSize),
+                kernels.dot(fa.data(), fb.data(), kSize), 1e-4);
+
+    FloatMatrix product(37, 41);
+    Gemm(ma, mb, product);
+    for (std::size_t i = 0; i < product.GetSize(); ++i) {
+      EXPECT_NEAR(product.Data()[i], expected_product.Data()[i], 1e-5);
+    }
+  }
+  SetSimdLevel(DetectSimdLevel());
+}
+
+TEST(Simd, DotU8S8) {
+  constexpr std::size_t kBytes = 300;
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<int> unsigned_bytes(0, kMaxDotU8);
+  std::uniform_int_distribution<int> signed_bytes(-128, 127);
+  std::vector<std::uint8_t> a(kBytes);
+  std::vector<std::int8_t> b(kBytes);
+  for (std::size_t i = 0; i < kBytes; ++i) {
+    a[i] = static_cast<std::uint8_t>(unsigned_bytes(gen));
+    b[i] = static_cast<std::int8_t>(signed_bytes(gen));
+  }
+  // The largest products saturate maddubs unless the operands are bounded.
+  std::fill(a.begin(), a.begin() + 64, kMaxDotU8);
+  std::fill(b.begin(), b.begin() + 64, -128);
+  for (SimdLevel level : SupportedLevels()) {
+    SetSimdLevel(level);
+    for (std::size_t n : {std::size_t{0}, std::size_t{15}, std::size_t{64},
+                          std::size_t{129}, kBytes}) {
+      std::int32_t expected = 0;
+      for (std::size_t i = 0; i < n; ++i) expected += a[i] * b[i];
+      EXPECT_EQ(GetSimdKernels().dot_u8s8(a.data(), b.data(), n), expected);
+      EXPECT_EQ(GetSimdKernels<float>().dot_u8s8(a.data(), b.data(), n),
+                expected);
+    }
+  }
+  SetSimdLevel(DetectSimdLevel());
+}
+
+TEST(Simd, FastExp) {
+  for (SimdLevel level : SupportedLevels()) {
+    SetSimdLevel(level);
+    const auto [exp_error, sigmoid_error] =
+        FastMathErrors(GetSimdKernels(), 700.0);
+    EXPECT_LT(exp_error, 2e-14);
+    EXPECT_LT(sigmoid_error, 5e-15);
+    const auto [float_exp_error, float_sigmoid_error] =
+        FastMathErrors(GetSimdKernels<float>(), 85.0);
+    EXPECT_LT(float_exp_error, 5e-7);
+    EXPECT_LT(float_sigmoid_error, 2e-7);
+  }
+  SetSimdLevel(DetectSimdLevel());
+
+  Matrix m(7, 13);
+  RandomizeMatrix(m);
+  MultiplyNumberInPlace(m, 20.0);
+  const Matrix exact = Activate(m, Activation::kSigmoid);
+  const Matrix fast = Activate(m, Activation::kSigmoid, MathMode::kFast);
+  for (std::size_t i = 0; i < m.GetSize(); ++i) {
+    EXPECT_NEAR(fast.Data()[i], exact.Data()[i], 5e-15);
+  }
+}
+
+TEST(Simd, Optimizers) {
+  const Vector gradients = RandomVector(kSize), weights = RandomVector(kSize);
+  const Vector first = RandomVector(kSize), squares = RandomVector(kSize);
+  Vector second(kSize);
+  for (std::size_t i = 0; i < kSize; ++i) second[i] = squares[i] * squares[i];
+  const SimdKernels::Update SimdKernels::*updates[] = {
+      &SimdKernels::momentum, &SimdKernels::nesterov, &SimdKernels::adam};
+  const BasicUpdateStep<double> step{0.05, 0.25, 0.9, 0.999, 1e-8};
+
+  for (std::size_t u = 0; u < 3; ++u) {
+    Vector expected_w = weights, expected_m = first, expected_s = second;
+    for (std::size_t i = 0; i < kSize; ++i) {
+      const double g = step.scale * gradients[i];
+      if (u < 2) {
+        expected_m[i] = step.beta1 * first[i] + g;
+        expected_w[i] -= step.lr * (u == 0 ? expected_m[i]
+                                           : g + step.beta1 * expected_m[i]);
+      } else {
+        expected_m[i] = step.beta1 * first[i] + (1 - step.beta1) * g;
+        expected_s[i] = step.beta2 * second[i] + (1 - step.beta2) * g * g;
+        expected_w[i] -= step.lr * expected_m[i] /
+                         (std::sqrt(expected_s[i]) + step.epsilon);
+      }
+    }
+    for (SimdLevel level : SupportedLevels()) {
+      SetSimdLevel(level);
+      Vector w = weights, m = first, s = second;
+      (GetSimdKernels().*updates[u])(gradients.data(), step, w.data(),
+                                     m.data(), s.data(), kSize);
+      for (std::size_t i = 0; i < kSize; ++i) {
+        EXPECT_NEAR(w[i], expected_w[i], kEps);
+        EXPECT_NEAR(m[i], expected_m[i], kEps);
+        EXPECT_NEAR(s[i], expected_s[i], kEps);
+      }
+    }
+  }
+  SetSimdLevel(DetectSimdLevel());
+}
+
+TEST(Simd, Clamp) {
+  SetSimdLevel(SimdLevel::kAvx512);
+  EXPECT_LE(GetSimdLevel(), DetectSimdLevel());
+  SetSimdLevel(DetectSimdLevel());
+}
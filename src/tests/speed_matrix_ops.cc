@@ -10,8 +10,8 @@ using namespace s21;
 
 int main() {
   system("clear");
-  Matrix m1 = Matrix(1000, Vector(1000));
-  Matrix m2 = Matrix(1000, Vector(1000));
+  Matrix m1 = Matrix(1000, 1000);
+  Matrix m2 = Matrix(1000, 1000);
   RandomizeMatrix(m1);
   RandomizeMatrix(m2);
   double d = 0.1;
@@ -20,6 +20,7 @@ int main() {
             << GetColor(Color::kCyan)
             << Align("1000x1000 MATRIX OPERATIONS SPEED TEST")
             << GetColor(Color::kEnd) << "\n\n";
+  std::cout << "SIMD kernels: " << GetSimdLevelName(GetSimdLevel()) << "\n";
 
   auto start = std::chrono::high_resolution_clock::now();
   for (int i = 0; i < 100; ++i) RandomizeMatrix(m1);
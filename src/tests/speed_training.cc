@@ -0,0 +1,88 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <thread>
+
+#include "mlp.h"
+
+using namespace s21;
+
+namespace {
+
+constexpr std::size_t kTrainImages = 20000;
+constexpr std::size_t kTestImages = 2000;
+
+// Noisy images whose label is drawn as a bright row, so the benchmark does
+// not depend on the EMNIST files.
+Dataset MakeDataset(std::size_t size, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<double> noise(0.0, 0.4);
+  Dataset dataset;
+  for (std::size_t i = 0; i < size; ++i) {
+    const std::size_t label = 1 + gen() % 26;
+    Image::Pixels pixels(Image::kPixels);
+    for (double& pixel : pixels) pixel = noise(gen);
+    for (std::size_t j = 0; j < Image::kWidth; ++j) {
+      pixels[(label - 1) * Image::kWidth + j] = 1.0;
+    }
+    Image image(pixels);
+    image.SetLabel(label);
+    dataset.push_back(image);
+  }
+  return dataset;
+}
+
+void Run(const std::string& name, Config::TrainType type,
+         std::size_t threads, const Dataset& train, const Dataset& test,
+         std::size_t batch_size = 1, double learning_rate = 0.1) {
+  MLP mlp{Topology{784, 128, 26}};
+  mlp.SetMFunc([](Metrics) {});
+  mlp.SetPFunc([](int) {});
+  mlp.SetFPFunc([](double) {});
+  mlp.SetTrainDataset(train);
+  mlp.SetTestDataset(test);
+  mlp.SetEpochs(1);
+  mlp.SetLearningRate(learning_rate);
+  mlp.SetTrainType(type);
+  mlp.SetThreads(threads);
+  mlp.SetBatchSize(batch_size);
+
+  auto start = std::chrono::high_resolution_clock::now();
+  mlp.Train();
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> elapsed = end - start;
+  mlp.Test();
+  std::cout << name << ": " << std::to_string(elapsed.count())
+            << " sec per epoch, accuracy "
+            << mlp.GetMetrics().GetAccuracy() << "\n";
+}
+
+}  // namespace
+
+int main() {
+  system("clear");
+  const Dataset train = MakeDataset(kTrainImages, 1);
+  const Dataset test = MakeDataset(kTestImages, 2);
+
+  std::cout << "\n"
+            << GetColor(Color::kCyan) << Align("SERIAL VS HOGWILD TRAINING")
+            << GetColor(Color::kEnd) << "\n\n";
+  std::cout << "SIMD kernels: " << GetSimdLevelName(GetSimdLevel()) << "\n";
+
+  Run("Serial", Config::TrainType::kTrain, 1, train, test);
+  // The averaged gradient of a batch takes a larger learning rate.
+  Run("Serial batch 32", Config::TrainType::kTrain, 1, train, test, 32, 0.5);
+  const std::size_t cores =
+      std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+  for (std::size_t threads = 2; threads <= cores; threads *= 2) {
+    Run("Hogwild " + std::to_string(threads) + " threads",
+        Config::TrainType::kHogwild, threads, train, test);
+  }
+  if (cores < 2) {
+    Run("Hogwild 2 threads (single core)", Config::TrainType::kHogwild, 2,
+        train, test);
+  }
+  std::cout << "\n"
+            << GetColor(Color::kCyan) << Align(" ") << GetColor(Color::kEnd)
+            << "\n\n";
+}
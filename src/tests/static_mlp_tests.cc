@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include "matrix_mlp.h"
+#include "static_mlp.h"
+
+using namespace s21;
+
+namespace {
+
+// Trains a static model and a matrix model with the same weights side by
+// side and checks that their outputs and weights stay the same.
+template <typename Model>
+void ExpectMatchesMatrixMlp(const Topology &topology, int steps) {
+  auto model = std::make_unique<Model>(topology);
+  MatrixMlp reference(topology);
+  const auto [weights, biases] = model->GetMlp();
+  reference.SetMlp(weights, biases);
+
+  const std::size_t outputs = topology.GetOutputSize();
+  Vector input(topology.GetInputSize()), expected(outputs, 0.0);
+  for (int step = 0; step < steps; ++step) {
+    RandomizeVector(input);
+    expected.assign(outputs, 0.0);
+    expected[step % outputs] = 1.0;
+    model->SetInputLayer(input);
+    model->ForwardPropagation();
+    reference.SetInputLayer(input);
+    reference.ForwardPropagation();
+    const Vector output = model->GetOutput();
+    const Vector reference_output = reference.GetOutput();
+    ASSERT_EQ(output.size(), reference_output.size());
+    for (std::size_t i = 0; i < output.size(); ++i) {
+      EXPECT_NEAR(output[i], reference_output[i], 1e-12);
+    }
+    model->BackPropagation(expected, 0.1);
+    reference.BackPropagation(expected, 0.1);
+  }
+
+  const auto [trained, trained_biases] = model->GetMlp();
+  const auto [reference_trained, reference_biases] = reference.GetMlp();
+  for (std::size_t l = 0; l < trained.size(); ++l) {
+    for (std::size_t i = 0; i < trained[l].GetSize(); ++i) {
+      EXPECT_NEAR(trained[l].begin()[i], reference_trained[l].begin()[i],
+                  1e-12);
+    }
+    for (std::size_t i = 0; i < trained_biases[l].GetSize(); ++i) {
+      EXPECT_NEAR(trained_biases[l].begin()[i],
+                  reference_biases[l].begin()[i], 1e-12);
+    }
+  }
+}
+
+}  // namespace
+
+TEST(StaticMlp, MatchesMatrixMlp) {
+  // No kernels are compiled for this shape, so it runs on the generic ones.
+  Topology topology{12, 8, 6, 4};
+  topology.SetActivation(Activation::kTanh, 2);
+  ExpectMatchesMatrixMlp<StaticMlp<12, 8, 6, 4>>(topology, 20);
+}
+
+TEST(StaticMlp, CompiledKernelsMatchMatrixMlp) {
+  // The kernels are picked when the model is built, for every level.
+  for (SimdLevel level : {SimdLevel::kScalar, SimdLevel::kSse42,
+                          SimdLevel::kAvx2, SimdLevel::kAvx512}) {
+    SetSimdLevel(level);
+    if (GetSimdLevel() != level) continue;
+    SCOPED_TRACE(GetSimdLevelName(level));
+    ExpectMatchesMatrixMlp<DefaultStaticMlp>(Topology{784, 100, 100, 26}, 3);
+  }
+  SetSimdLevel(DetectSimdLevel());
+}
+
+TEST(StaticMlp, RejectsOtherShapes) {
+  using Small = StaticMlp<4, 3, 2>;
+  EXPECT_THROW(Small(Topology{4, 5, 2}), std::invalid_argument);
+  EXPECT_THROW(MakeStaticMlp(Topology{4, 5, 2}), std::invalid_argument);
+  EXPECT_NE(MakeStaticMlp(Topology{784, 100, 100, 26}), nullptr);
+
+  Small model(Topology{4, 3, 2});
+  const MatrixMlp other(Topology{4, 5, 2});
+  const auto [weights, biases] = other.GetMlp();
+  EXPECT_THROW(model.SetMlp(weights, biases), std::invalid_argument);
+  EXPECT_THROW(model.SetInputLayer(Vector(5)), std::invalid_argument);
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <numeric>
+
+#include "thread_pool.h"
+
+using namespace s21;
+
+TEST(ThreadPool, ParallelFor) {
+  ThreadPool pool(3);
+  for (std::size_t count : {0, 1, 2, 7, 1000}) {
+    std::vector<int> hits(count);
+    pool.ParallelFor(count, [&](std::size_t i) { ++hits[i]; });
+    EXPECT_EQ(std::count(hits.begin(), hits.end(), 1),
+              static_cast<std::ptrdiff_t>(count));
+  }
+}
+
+TEST(ThreadPool, Ranges) {
+  ThreadPool pool(2);
+  std::vector<int> hits(103);
+  pool.ParallelForRange(hits.size(), 10, [&](std::size_t b, std::size_t e) {
+    for (std::size_t i = b; i < e; ++i) ++hits[i];
+  });
+  EXPECT_EQ(std::accumulate(hits.begin(), hits.end(), 0), 103);
+
+  std::vector<int> tiles(37 * 29);
+  pool.ParallelFor2D(37, 29, 8, 5,
+                     [&](std::size_t rb, std::size_t re, std::size_t cb,
+                         std::size_t ce) {
+                       for (std::size_t i = rb; i < re; ++i) {
+                         for (std::size_t j = cb; j < ce; ++j) {
+                           ++tiles[i * 29 + j];
+                         }
+                       }
+                     });
+  EXPECT_EQ(std::count(tiles.begin(), tiles.end(), 1),
+            static_cast<std::ptrdiff_t>(tiles.size()));
+}
+
+TEST(ThreadPool, Nested) {
+  ThreadPool pool(2);
+  std::atomic<int> sum{0};
+  pool.ParallelFor(8, [&](std::size_t) {
+    pool.ParallelFor(8, [&](std::size_t j) { sum += static_cast<int>(j); });
+  });
+  EXPECT_EQ(sum, 8 * 28);
+}
+
+TEST(ThreadPool, Exceptions) {
+  ThreadPool pool(2);
+  EXPECT_THROW(pool.ParallelFor(50,
+                                [](std::size_t i) {
+                                  if (i == 17) throw std::runtime_error("");
+                                }),
+               std::runtime_error);
+  EXPECT_EQ(pool.enqueue([](int x) { return x * 2; }, 21).get(), 42);
+  pool.Resize(0);
+  EXPECT_EQ(pool.GetThreadsCount(), 0);
+  int calls = 0;
+  pool.ParallelFor(5, [&](std::size_t) { ++calls; });
+  EXPECT_EQ(calls, 5);
+}
+
+TEST(ThreadPool, Graph) {
+  ThreadPool pool(3);
+  // Two branches joining, plus a skip edge from the source to the sink.
+  const std::vector<std::vector<std::size_t>> successors{
+      {1, 2, 5}, {3}, {4}, {5}, {5}, {}};
+  for (int run = 0; run < 20; ++run) {
+    std::atomic<int> clock{0};
+    std::vector<int> start(successors.size()), end(successors.size());
+    pool.ParallelForGraph(successors, [&](std::size_t node) {
+      start[node] = clock++;
+      end[node] = clock++;
+    });
+    for (std::size_t node = 0; node < successors.size(); ++node) {
+      for (std::size_t next : successors[node]) {
+        EXPECT_LT(end[node], start[next]);
+      }
+    }
+  }
+
+  EXPECT_THROW(pool.ParallelForGraph({{1}, {2}, {1}}, [](std::size_t) {}),
+               std::invalid_argument);
+  EXPECT_THROW(pool.ParallelForGraph({{3}}, [](std::size_t) {}),
+               std::invalid_argument);
+  const auto fail = [](std::size_t node) {
+    if (node == 1) throw std::logic_error("");
+  };
+  EXPECT_THROW(pool.ParallelForGraph({{1, 2}, {}, {}}, fail),
+               std::logic_error);
+}